@@ -0,0 +1,224 @@
+#include <SDL.h>
+#include <SDL_image.h>
+#include <SDL_mixer.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#include "AssetPackFormat.h"
+
+/**
+ * Checks if a path ends with one of the given extensions, ignoring case.
+ * @param path The file path.
+ * @param extensions A null-terminated list of extensions including the dot.
+ * @return True if the extension matches, false otherwise.
+ */
+static bool hasExtension(const std::string& path, const char* const* extensions) {
+    std::string lower = path;
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return static_cast<char>(SDL_tolower(c)); });
+    for (const char* const* ext = extensions; *ext != nullptr; ++ext) {
+        size_t length = std::strlen(*ext);
+        if (lower.size() >= length && lower.compare(lower.size() - length, length, *ext) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Writes zero bytes until the file offset is a multiple of the alignment.
+ * @param file The output file.
+ * @param alignment The alignment in bytes.
+ * @param offset The current offset, advanced past the padding.
+ * @return True if the padding was written, false otherwise.
+ */
+static bool writePadding(FILE* file, Uint64 alignment, Uint64& offset) {
+    static const Uint8 zeros[ASSET_PACK_DATA_ALIGNMENT] = {};
+    Uint64 padding = (alignment - offset % alignment) % alignment;
+    if (padding > 0 && fwrite(zeros, 1, static_cast<size_t>(padding), file) != padding) {
+        return false;
+    }
+    offset += padding;
+    return true;
+}
+
+/**
+ * Decodes an image, converts it to premultiplied ARGB8888 with cache-line
+ * aligned rows and appends it to the pack.
+ * @param file The output file, positioned at offset.
+ * @param path The image file path.
+ * @param entry The index entry to fill in.
+ * @param offset The current file offset, advanced past the pixels.
+ * @return True if the image was packed, false otherwise.
+ */
+static bool packTexture(FILE* file, const std::string& path, AssetPackEntry& entry, Uint64& offset) {
+    SDL_Surface* loaded = IMG_Load(path.c_str());
+    if (loaded == nullptr) {
+        printf("Unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+        return false;
+    }
+    SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_ARGB8888, 0);
+    SDL_FreeSurface(loaded);
+    if (surface == nullptr) {
+        printf("Unable to convert image %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
+        return false;
+    }
+    premultiplyAlpha(surface);
+
+    Uint32 rowBytes = static_cast<Uint32>(surface->w) * 4;
+    Uint32 pitch = (rowBytes + ASSET_PACK_ROW_ALIGNMENT - 1) / ASSET_PACK_ROW_ALIGNMENT * ASSET_PACK_ROW_ALIGNMENT;
+    std::vector<Uint8> row(pitch, 0);
+    bool success = true;
+    for (int y = 0; y < surface->h && success; ++y) {
+        std::memcpy(row.data(), static_cast<Uint8*>(surface->pixels) + y * surface->pitch, rowBytes);
+        success = fwrite(row.data(), 1, pitch, file) == pitch;
+    }
+
+    entry.type = ASSET_PACK_TEXTURE;
+    entry.format = SDL_PIXELFORMAT_ARGB8888;
+    entry.width = static_cast<Uint32>(surface->w);
+    entry.height = static_cast<Uint32>(surface->h);
+    entry.pitch = pitch;
+    entry.size = static_cast<Uint64>(pitch) * surface->h;
+    offset += entry.size;
+    SDL_FreeSurface(surface);
+    return success;
+}
+
+/**
+ * Decodes a sound to PCM in the mixer's output format and appends it to the pack.
+ * @param file The output file, positioned at offset.
+ * @param path The sound file path.
+ * @param entry The index entry to fill in.
+ * @param offset The current file offset, advanced past the samples.
+ * @return True if the sound was packed, false otherwise.
+ */
+static bool packSound(FILE* file, const std::string& path, AssetPackEntry& entry, Uint64& offset) {
+    Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+    if (chunk == nullptr) {
+        printf("Failed to load sound %s! SDL_mixer Error: %s\n", path.c_str(), Mix_GetError());
+        return false;
+    }
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    Mix_QuerySpec(&frequency, &format, &channels);
+
+    entry.type = ASSET_PACK_SOUND;
+    entry.format = format;
+    entry.width = static_cast<Uint32>(frequency);
+    entry.height = static_cast<Uint32>(channels);
+    entry.pitch = 0;
+    entry.size = chunk->alen;
+    bool success = fwrite(chunk->abuf, 1, chunk->alen, file) == chunk->alen;
+    offset += entry.size;
+    Mix_FreeChunk(chunk);
+    return success;
+}
+
+/**
+ * Entry point of the asset packer.
+ * Usage: AssetPacker <output.pack> <file>...
+ * Run it from the game directory so the stored names match the paths the game loads.
+ * @param argc The number of command-line arguments.
+ * @param args The array of command-line arguments.
+ * @return 0 on success, 1 on failure.
+ */
+int main(int argc, char* args[]) {
+    if (argc < 3) {
+        printf("Usage: AssetPacker <output.pack> <file>...\n");
+        return 1;
+    }
+
+    // Sounds are decoded by an open mixer; it does not need a real audio device
+    SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+    if (SDL_Init(SDL_INIT_AUDIO) < 0) {
+        printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
+        return 1;
+    }
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG);
+    Mix_Init(MIX_INIT_MP3);
+    // Must match the format Subsystems::ensureAudio opens the mixer with
+    if (Mix_OpenAudio(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, 4096) != 0) {
+        printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    FILE* file = fopen(args[1], "wb");
+    if (file == nullptr) {
+        printf("Unable to create %s!\n", args[1]);
+        Mix_CloseAudio();
+        SDL_Quit();
+        return 1;
+    }
+
+    static const char* const imageExtensions[] = { ".png", ".jpg", ".jpeg", ".bmp", nullptr };
+    static const char* const soundExtensions[] = { ".wav", ".mp3", ".ogg", nullptr };
+
+    // The header is rewritten once the index offset is known
+    AssetPackHeader header = {};
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1;
+    Uint64 offset = sizeof(header);
+
+    std::vector<AssetPackEntry> entries;
+    for (int i = 2; i < argc && success; ++i) {
+        std::string path = args[i];
+        if (path.size() >= ASSET_PACK_NAME_LENGTH) {
+            printf("Skipping %s: name is too long\n", path.c_str());
+            continue;
+        }
+
+        AssetPackEntry entry = {};
+        std::memcpy(entry.name, path.c_str(), path.size());
+        success = writePadding(file, ASSET_PACK_DATA_ALIGNMENT, offset);
+        entry.offset = offset;
+
+        bool packed = false;
+        if (hasExtension(path, imageExtensions)) {
+            packed = packTexture(file, path, entry, offset);
+        }
+        else if (hasExtension(path, soundExtensions)) {
+            packed = packSound(file, path, entry, offset);
+        }
+        else {
+            printf("Skipping %s: unknown file type\n", path.c_str());
+        }
+        if (packed) {
+            printf("  %-8s %10llu bytes  %s\n", entry.type == ASSET_PACK_TEXTURE ? "texture" : "sound",
+                static_cast<unsigned long long>(entry.size), entry.name);
+            entries.push_back(entry);
+        }
+    }
+
+    if (success) {
+        success = writePadding(file, alignof(AssetPackEntry), offset);
+    }
+    header.magic = ASSET_PACK_MAGIC;
+    header.version = ASSET_PACK_VERSION;
+    header.entryCount = static_cast<Uint32>(entries.size());
+    header.entrySize = sizeof(AssetPackEntry);
+    header.indexOffset = offset;
+    if (success && !entries.empty()) {
+        success = fwrite(entries.data(), sizeof(AssetPackEntry), entries.size(), file) == entries.size();
+    }
+    if (success) {
+        success = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+    success = fclose(file) == 0 && success;
+
+    if (success) {
+        printf("Wrote %u assets to %s\n", header.entryCount, args[1]);
+    }
+    else {
+        printf("Failed to write %s!\n", args[1]);
+        remove(args[1]);
+    }
+
+    Mix_CloseAudio();
+    Mix_Quit();
+    IMG_Quit();
+    SDL_Quit();
+    return success ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+#ifndef UINT128_H
+#define UINT128_H
+
+#include <cstdint>
+#include <string>
+
+// Unsigned 128-bit integer for exact cycle counts, which overflow 64 bits on
+// machines with many or long reels. Portable C++: MSVC has no __int128.
+struct UInt128 {
+    uint64_t high;
+    uint64_t low;
+
+    UInt128() : high(0), low(0) {}
+    UInt128(uint64_t value) : high(0), low(value) {}
+    UInt128(uint64_t highBits, uint64_t lowBits) : high(highBits), low(lowBits) {}
+
+    bool isZero() const { return high == 0 && low == 0; }
+
+    UInt128& operator+=(const UInt128& other) {
+        uint64_t sum = low + other.low;
+        high += other.high + (sum < low ? 1 : 0);
+        low = sum;
+        return *this;
+    }
+
+    UInt128& operator-=(const UInt128& other) {
+        uint64_t difference = low - other.low;
+        high -= other.high + (difference > low ? 1 : 0);
+        low = difference;
+        return *this;
+    }
+
+    // Wraps modulo 2^128 like the built-in unsigned types
+    UInt128 operator*(uint64_t factor) const {
+        UInt128 product = multiply(low, factor);
+        product.high += high * factor;
+        return product;
+    }
+
+    UInt128 operator*(const UInt128& other) const {
+        UInt128 product = multiply(low, other.low);
+        product.high += high * other.low + low * other.high;
+        return product;
+    }
+
+    bool operator==(const UInt128& other) const { return high == other.high && low == other.low; }
+    bool operator!=(const UInt128& other) const { return !(*this == other); }
+    bool operator<(const UInt128& other) const { return high != other.high ? high < other.high : low < other.low; }
+
+    // Full 64 x 64 -> 128-bit product from 32-bit halves
+    static UInt128 multiply(uint64_t a, uint64_t b) {
+        uint64_t aLow = a & 0xFFFFFFFFu;
+        uint64_t aHigh = a >> 32;
+        uint64_t bLow = b & 0xFFFFFFFFu;
+        uint64_t bHigh = b >> 32;
+        uint64_t lowLow = aLow * bLow;
+        uint64_t lowHigh = aLow * bHigh;
+        uint64_t highLow = aHigh * bLow;
+        uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFu) + (highLow & 0xFFFFFFFFu);
+        return UInt128(aHigh * bHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32),
+            (middle << 32) | (lowLow & 0xFFFFFFFFu));
+    }
+
+    // Binary long division; slow, but only used to format and reduce results
+    static void divide(const UInt128& dividend, const UInt128& divisor, UInt128& quotient, UInt128& remainder) {
+        quotient = UInt128();
+        remainder = UInt128();
+        for (int bit = 127; bit >= 0; --bit) {
+            remainder = UInt128((remainder.high << 1) | (remainder.low >> 63), remainder.low << 1);
+            uint64_t word = bit >= 64 ? dividend.high : dividend.low;
+            remainder.low |= (word >> (bit & 63)) & 1;
+            if (!(remainder < divisor)) {
+                remainder -= divisor;
+                if (bit >= 64) {
+                    quotient.high |= uint64_t(1) << (bit - 64);
+                }
+                else {
+                    quotient.low |= uint64_t(1) << bit;
+                }
+            }
+        }
+    }
+
+    static UInt128 gcd(UInt128 a, UInt128 b) {
+        while (!b.isZero()) {
+            UInt128 quotient;
+            UInt128 remainder;
+            divide(a, b, quotient, remainder);
+            a = b;
+            b = remainder;
+        }
+        return a;
+    }
+
+    double toDouble() const {
+        return static_cast<double>(high) * 18446744073709551616.0 + static_cast<double>(low);
+    }
+
+    std::string toString() const {
+        if (isZero()) {
+            return "0";
+        }
+        std::string digits;
+        UInt128 value = *this;
+        while (!value.isZero()) {
+            UInt128 quotient;
+            UInt128 remainder;
+            divide(value, UInt128(10), quotient, remainder);
+            digits.insert(digits.begin(), static_cast<char>('0' + remainder.low));
+            value = quotient;
+        }
+        return digits;
+    }
+};
+
+#endif // UINT128_H
@@ -0,0 +1,890 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <system_error>
+#include <map>
+#include "OutcomeEngine.h"
+#include "Random.h"
+#include "UInt128.h"
+
+// Totals of one worker; each worker fills its own copy, merged after the join
+struct SpinStats {
+    uint64_t spins;
+    uint64_t totalWin;       // In line bets
+    UInt128 totalWinSquared; // Sum of the squared spin wins, for the variance; overflows 64 bits with large pays
+    uint64_t hits;           // Spins with any win
+    uint32_t maxWin;
+    double seconds;          // Time the worker spent spinning
+    LineCounts combos;       // Paying lines by symbol and count
+};
+
+// Spins done so far by one worker, read by the main thread for progress.
+// Aligned to a cache line so two workers never write to the same one; the
+// vector of them relies on C++17 aligned new.
+struct alignas(64) WorkerProgress {
+    std::atomic<uint64_t> spins;
+};
+
+static const uint64_t PROGRESS_INTERVAL = 1 << 20; // Spins between progress updates
+static const int SPIN_BATCH = 1024;                 // Spins evaluated per call into the engine
+
+/**
+ * Adds the totals of one worker to another.
+ * @param total The totals to add to.
+ * @param stats The worker totals.
+ */
+static void mergeStats(SpinStats& total, const SpinStats& stats) {
+    total.spins += stats.spins;
+    total.totalWin += stats.totalWin;
+    total.totalWinSquared += stats.totalWinSquared;
+    total.hits += stats.hits;
+    if (stats.maxWin > total.maxWin) {
+        total.maxWin = stats.maxWin;
+    }
+    total.seconds += stats.seconds;
+    for (int symbol = 0; symbol < MachineConfig::MAX_SYMBOLS; ++symbol) {
+        for (int count = 0; count <= MachineConfig::MAX_REELS; ++count) {
+            total.combos.lines[symbol][count] += stats.combos.lines[symbol][count];
+        }
+    }
+}
+
+/**
+ * Worker entry point. Runs its share of the spins on its own random stream,
+ * in batches so the payline kernels evaluate many windows per call, and
+ * writes the totals only once, when it is done.
+ * @param engine The outcome engine, shared read-only by all workers.
+ * @param random The worker's random stream.
+ * @param spins The number of spins to run.
+ * @param progress Receives the number of spins done so far.
+ * @param result Receives the totals.
+ */
+static void runWorker(const OutcomeEngine& engine, Random random, uint64_t spins, WorkerProgress& progress, SpinStats& result) {
+    auto start = std::chrono::steady_clock::now();
+    SpinStats stats = {};
+    uint32_t wins[SPIN_BATCH];
+    uint64_t done = 0;
+    while (done < spins) {
+        uint64_t chunk = spins - done < PROGRESS_INTERVAL ? spins - done : PROGRESS_INTERVAL;
+        for (uint64_t i = 0; i < chunk; i += SPIN_BATCH) {
+            int count = static_cast<int>(chunk - i < SPIN_BATCH ? chunk - i : SPIN_BATCH);
+            engine.spinWins(random, count, wins, &stats.combos);
+            for (int spin = 0; spin < count; ++spin) {
+                uint64_t win = wins[spin];
+                stats.totalWin += win;
+                stats.totalWinSquared += win * win;
+                stats.hits += win > 0 ? 1 : 0;
+                stats.maxWin = wins[spin] > stats.maxWin ? wins[spin] : stats.maxWin;
+            }
+        }
+        done += chunk;
+        progress.spins.store(done, std::memory_order_relaxed);
+    }
+    stats.spins = done;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result = stats;
+}
+
+/**
+ * Parses a spin count, allowing exponent notation such as 1e10.
+ * @param text The command-line argument.
+ * @param value Receives the count.
+ * @return True if the text is a positive count, false otherwise.
+ */
+static bool parseCount(const char* text, uint64_t& value) {
+    char* end = nullptr;
+    double parsed = strtod(text, &end);
+    if (end == text || *end != '\0' || !(parsed >= 1.0) || parsed > 1.8e19) {
+        return false;
+    }
+    value = static_cast<uint64_t>(parsed);
+    return true;
+}
+
+/**
+ * Prints the results of a run.
+ * @param engine The outcome engine that was simulated.
+ * @param stats The merged totals of all workers.
+ * @param seconds The wall-clock time until the last worker finished.
+ * @param threadCount The number of worker threads.
+ */
+static void printReport(const OutcomeEngine& engine, const SpinStats& stats, double seconds, unsigned threadCount) {
+    const MachineConfig& config = engine.getConfig();
+    double spins = static_cast<double>(stats.spins);
+    double bet = static_cast<double>(engine.getLineCount()); // One line bet on every line
+
+    // Return of a single spin as a fraction of its bet; the RTP is its mean
+    double rtp = stats.totalWin / bet / spins;
+    double meanSquare = stats.totalWinSquared.toDouble() / (bet * bet) / spins;
+    double deviation = std::sqrt(std::max(0.0, meanSquare - rtp * rtp));
+    double rtpError = deviation / std::sqrt(spins);
+    double hitRate = stats.hits / spins;
+    double hitError = std::sqrt(hitRate * (1.0 - hitRate) / spins);
+
+    printf("\nSpins:            %llu\n", static_cast<unsigned long long>(stats.spins));
+    printf("RTP:              %.6f%%\n", rtp * 100.0);
+    printf("  95%% CI:         %.6f%% .. %.6f%%\n", (rtp - 1.96 * rtpError) * 100.0, (rtp + 1.96 * rtpError) * 100.0);
+    printf("  99%% CI:         %.6f%% .. %.6f%%\n", (rtp - 2.576 * rtpError) * 100.0, (rtp + 2.576 * rtpError) * 100.0);
+    printf("Hit rate:         %.6f%% (1 in %.3f), 95%% CI +/- %.6f%%\n",
+        hitRate * 100.0, hitRate > 0.0 ? 1.0 / hitRate : 0.0, 1.96 * hitError * 100.0);
+    printf("Std deviation:    %.4f bets per spin\n", deviation);
+    printf("Volatility index: %.4f (90%%)\n", 1.645 * deviation);
+    printf("Max win:          %u line bets\n", stats.maxWin);
+
+    printf("\nSymbol  Count  Pay      Lines hit         1 in          RTP share\n");
+    for (size_t symbol = 0; symbol < config.pays.size(); ++symbol) {
+        for (size_t count = 0; count < config.pays[symbol].size(); ++count) {
+            uint32_t pay = config.pays[symbol][count];
+            if (pay == 0) continue;
+            uint64_t lines = stats.combos.lines[symbol][count];
+            double share = static_cast<double>(lines) * pay / bet / spins;
+            printf("%6d  %5d  %5u  %13llu  %11.1f  %16.6f%%\n", static_cast<int>(symbol), static_cast<int>(count), pay,
+                static_cast<unsigned long long>(lines), lines > 0 ? spins / lines : 0.0, share * 100.0);
+        }
+    }
+
+    printf("\nTime:             %.2f s on %u threads\n", seconds, threadCount);
+    printf("Throughput:       %.0f spins/s, %.0f spins/s/core\n", spins / seconds, stats.seconds > 0.0 ? spins / stats.seconds : 0.0);
+}
+
+// Distinct windows of one reel: stops that show the same symbols in every row
+// always pay the same, so each window is enumerated once with its stop count
+struct ReelWindows {
+    std::vector<int> symbols; // Symbols of each window, top to bottom, one window after another
+    std::vector<uint64_t> stops; // Number of stops showing each window
+    std::vector<int> firstStops; // First stop showing each window
+};
+
+// Exact totals over part of the cycle; each worker fills its own copy
+struct ExactStats {
+    UInt128 totalWin; // In line bets
+    UInt128 hits;     // Stop combinations with any win
+    std::map<uint32_t, UInt128> distribution; // Stop combinations by total win
+    uint64_t visited; // Prefixes evaluated, to show the effect of pruning
+};
+
+// Read-only tables shared by the enumeration workers
+struct Enumeration {
+    const MachineConfig* config;
+    const OutcomeEngine* engine;
+    bool prune; // Only without wilds and right-to-left pays, where a broken line stays broken
+    std::vector<ReelWindows> reels;
+    std::vector<UInt128> remaining; // remaining[reel]: stop combinations of the reels from reel on
+};
+
+/**
+ * Groups the stops of every reel by the window they show.
+ * @param config The machine.
+ * @return The distinct windows of each reel.
+ */
+static std::vector<ReelWindows> buildReelWindows(const MachineConfig& config) {
+    std::vector<ReelWindows> reels(config.strips.size());
+    for (size_t reel = 0; reel < config.strips.size(); ++reel) {
+        const std::vector<int>& strip = config.strips[reel];
+        std::map<std::vector<int>, size_t> seen;
+        for (size_t stop = 0; stop < strip.size(); ++stop) {
+            std::vector<int> window(config.rows);
+            for (int row = 0; row < config.rows; ++row) {
+                window[row] = strip[(stop + row) % strip.size()];
+            }
+            auto found = seen.find(window);
+            if (found != seen.end()) {
+                ++reels[reel].stops[found->second];
+                continue;
+            }
+            seen[window] = reels[reel].stops.size();
+            reels[reel].symbols.insert(reels[reel].symbols.end(), window.begin(), window.end());
+            reels[reel].stops.push_back(1);
+            reels[reel].firstStops.push_back(static_cast<int>(stop));
+        }
+    }
+    return reels;
+}
+
+/**
+ * Looks up a line pay, treating counts past the end of the paytable row as unpaid.
+ * @param config The machine.
+ * @param symbol The symbol of the run.
+ * @param count The length of the run.
+ * @return The pay in line bets.
+ */
+static uint32_t getPay(const MachineConfig& config, int symbol, int count) {
+    const std::vector<uint32_t>& pays = config.pays[symbol];
+    return count < static_cast<int>(pays.size()) ? pays[count] : 0;
+}
+
+/**
+ * Adds stop combinations that all pay the same to the totals.
+ * @param stats The totals.
+ * @param win The total win of each combination.
+ * @param combinations The number of combinations.
+ */
+static void recordExact(ExactStats& stats, uint32_t win, const UInt128& combinations) {
+    stats.totalWin += combinations * win;
+    if (win > 0) {
+        stats.hits += combinations;
+    }
+    stats.distribution[win] += combinations;
+}
+
+/**
+ * Evaluates one window of a reel after the windows of the reels before it,
+ * then recurses into the next reel. Once every line's run has ended the
+ * remaining reels cannot change the win, so all their combinations are
+ * counted at once instead of being walked.
+ * @param enumeration The shared tables.
+ * @param reel The reel being placed.
+ * @param window The window index on that reel.
+ * @param weight Stop combinations of the reels before this one that lead here.
+ * @param symbols The symbol of each line's run; ignored on the first reel.
+ * @param counts The length of each line's run; ignored on the first reel.
+ * @param stats Receives the totals.
+ */
+static void enumerateWindow(const Enumeration& enumeration, int reel, size_t window, const UInt128& weight,
+    const int* symbols, const int* counts, ExactStats& stats) {
+    const MachineConfig& config = *enumeration.config;
+    const ReelWindows& windows = enumeration.reels[reel];
+    const int* shown = windows.symbols.data() + window * config.rows;
+    int lineCount = static_cast<int>(config.paylines.size());
+    int reelCount = static_cast<int>(config.strips.size());
+    ++stats.visited;
+
+    int nextSymbols[MachineConfig::MAX_PAYLINES];
+    int nextCounts[MachineConfig::MAX_PAYLINES];
+    bool running = false;
+    for (int line = 0; line < lineCount; ++line) {
+        int symbol = shown[config.paylines[line][reel]];
+        if (reel == 0) {
+            nextSymbols[line] = symbol;
+            nextCounts[line] = 1;
+            running = true;
+        }
+        else {
+            bool extends = counts[line] == reel && symbol == symbols[line];
+            nextSymbols[line] = symbols[line];
+            nextCounts[line] = extends ? reel + 1 : counts[line];
+            running = running || extends;
+        }
+    }
+
+    UInt128 combinations = weight * windows.stops[window];
+    if (running && reel + 1 < reelCount) {
+        for (size_t next = 0; next < enumeration.reels[reel + 1].stops.size(); ++next) {
+            enumerateWindow(enumeration, reel + 1, next, combinations, nextSymbols, nextCounts, stats);
+        }
+        return;
+    }
+
+    uint32_t win = 0;
+    for (int line = 0; line < lineCount; ++line) {
+        win += getPay(config, nextSymbols[line], nextCounts[line]);
+    }
+    recordExact(stats, win, combinations * enumeration.remaining[reel + 1]);
+}
+
+/**
+ * Walks every combination of distinct windows from a reel on and evaluates
+ * each with the outcome engine. Used for machines with wilds or right-to-left
+ * pays, where a later reel can still complete a line.
+ * @param enumeration The shared tables.
+ * @param reel The reel being placed.
+ * @param window The window index on that reel.
+ * @param weight Stop combinations of the reels before this one that lead here.
+ * @param stops A stop showing each placed window; this reel's entry is filled in.
+ * @param stats Receives the totals.
+ */
+static void enumerateStops(const Enumeration& enumeration, int reel, size_t window, const UInt128& weight,
+    int* stops, ExactStats& stats) {
+    const ReelWindows& windows = enumeration.reels[reel];
+    stops[reel] = windows.firstStops[window];
+    ++stats.visited;
+
+    UInt128 combinations = weight * windows.stops[window];
+    if (reel + 1 < static_cast<int>(enumeration.reels.size())) {
+        for (size_t next = 0; next < enumeration.reels[reel + 1].stops.size(); ++next) {
+            enumerateStops(enumeration, reel + 1, next, combinations, stops, stats);
+        }
+        return;
+    }
+    recordExact(stats, enumeration.engine->evaluateWin(stops), combinations);
+}
+
+/**
+ * Worker entry point for the exact evaluation. Takes first-reel windows from
+ * the shared counter until none are left, so uneven subtrees balance out.
+ * @param enumeration The shared tables.
+ * @param nextWindow The next first-reel window nobody has taken.
+ * @param result Receives the totals.
+ */
+static void runExactWorker(const Enumeration& enumeration, std::atomic<size_t>& nextWindow, ExactStats& result) {
+    size_t windowCount = enumeration.reels[0].stops.size();
+    int stops[MachineConfig::MAX_REELS];
+    for (size_t window = nextWindow++; window < windowCount; window = nextWindow++) {
+        if (enumeration.prune) {
+            enumerateWindow(enumeration, 0, window, UInt128(1), nullptr, nullptr, result);
+        }
+        else {
+            enumerateStops(enumeration, 0, window, UInt128(1), stops, result);
+        }
+    }
+}
+
+/**
+ * Walks every reel-stop combination of the full cycle and prints the exact
+ * RTP as a reduced fraction, the exact hit count and the win distribution.
+ * @param engine The outcome engine of the machine.
+ * @param threadCount The number of worker threads.
+ * @return True if the evaluation ran, false otherwise.
+ */
+static bool runExact(const OutcomeEngine& engine, unsigned threadCount) {
+    const MachineConfig& config = engine.getConfig();
+    Enumeration enumeration;
+    enumeration.config = &config;
+    enumeration.engine = &engine;
+    enumeration.prune = config.wild < 0 && !config.bothWays;
+    enumeration.reels = buildReelWindows(config);
+    enumeration.remaining.assign(config.strips.size() + 1, UInt128(1));
+    for (int reel = static_cast<int>(config.strips.size()) - 1; reel >= 0; --reel) {
+        enumeration.remaining[reel] = enumeration.remaining[reel + 1] * static_cast<uint64_t>(config.strips[reel].size());
+    }
+    UInt128 cycle = enumeration.remaining[0];
+
+    printf("Enumerating a cycle of %s stop combinations on %u threads\n", cycle.toString().c_str(), threadCount);
+    for (size_t reel = 0; reel < enumeration.reels.size(); ++reel) {
+        printf("  Reel %d: %d stops, %d distinct windows\n", static_cast<int>(reel) + 1,
+            static_cast<int>(config.strips[reel].size()), static_cast<int>(enumeration.reels[reel].stops.size()));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::atomic<size_t> nextWindow(0);
+    std::vector<ExactStats> results(threadCount);
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threadCount; ++i) {
+        results[i].visited = 0;
+        try {
+            workers.emplace_back(runExactWorker, std::cref(enumeration), std::ref(nextWindow), std::ref(results[i]));
+        }
+        catch (const std::system_error& e) {
+            printf("Worker thread could not be started! Error: %s\n", e.what());
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            return false;
+        }
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ExactStats total;
+    total.visited = 0;
+    for (const ExactStats& stats : results) {
+        total.totalWin += stats.totalWin;
+        total.hits += stats.hits;
+        total.visited += stats.visited;
+        for (const auto& entry : stats.distribution) {
+            total.distribution[entry.first] += entry.second;
+        }
+    }
+
+    // The RTP is the total win over the total bet of one line bet on every line
+    UInt128 totalBet = cycle * static_cast<uint64_t>(engine.getLineCount());
+    UInt128 divisor = UInt128::gcd(total.totalWin, totalBet);
+    UInt128 numerator;
+    UInt128 denominator;
+    UInt128 remainder;
+    UInt128::divide(total.totalWin, divisor, numerator, remainder);
+    UInt128::divide(totalBet, divisor, denominator, remainder);
+
+    double bet = static_cast<double>(engine.getLineCount());
+    double rtp = total.totalWin.toDouble() / totalBet.toDouble();
+    double meanSquare = 0.0;
+    for (const auto& entry : total.distribution) {
+        double spinReturn = entry.first / bet;
+        meanSquare += entry.second.toDouble() / cycle.toDouble() * spinReturn * spinReturn;
+    }
+    double deviation = std::sqrt(std::max(0.0, meanSquare - rtp * rtp));
+
+    printf("\nTotal bet:        %s line bets\n", totalBet.toString().c_str());
+    printf("Total win:        %s line bets\n", total.totalWin.toString().c_str());
+    printf("RTP:              %s / %s = %.10f%%\n", numerator.toString().c_str(), denominator.toString().c_str(), rtp * 100.0);
+    printf("Hits:             %s of %s = %.10f%%\n", total.hits.toString().c_str(), cycle.toString().c_str(),
+        total.hits.toDouble() / cycle.toDouble() * 100.0);
+    printf("Std deviation:    %.4f bets per spin\n", deviation);
+    printf("Volatility index: %.4f (90%%)\n", 1.645 * deviation);
+
+    printf("\n  Win  Combinations          Probability       1 in\n");
+    for (const auto& entry : total.distribution) {
+        double probability = entry.second.toDouble() / cycle.toDouble();
+        printf("%5u  %20s  %.10f  %9.1f\n", entry.first, entry.second.toString().c_str(), probability, 1.0 / probability);
+    }
+
+    printf("\nEvaluated %llu window prefixes instead of %s combinations in %.3f s\n",
+        static_cast<unsigned long long>(total.visited), cycle.toString().c_str(), seconds);
+    return true;
+}
+
+// Stop sets drawn for the benchmark, and how often each measurement walks them
+static const int BENCHMARK_SPINS = 1 << 16;
+static const int BENCHMARK_ROUNDS = 256;
+
+// Flat tables of the per-line loop the engine used before the batch kernels
+struct ReferenceMachine {
+    int reelCount;
+    int lineCount;
+    int stripLengths[MachineConfig::MAX_REELS];
+    std::vector<uint8_t> strips[MachineConfig::MAX_REELS]; // Each strip followed by its first rows - 1 symbols
+    uint8_t lines[MachineConfig::MAX_PAYLINES][MachineConfig::MAX_REELS];
+    uint32_t pays[MachineConfig::MAX_SYMBOLS][MachineConfig::MAX_REELS + 1];
+};
+
+/**
+ * Copies a machine into the tables of the per-line loop.
+ * @param config The machine; must pay left to right only, without a wild.
+ * @param machine Receives the tables.
+ */
+static void buildReference(const MachineConfig& config, ReferenceMachine& machine) {
+    memset(machine.lines, 0, sizeof(machine.lines));
+    memset(machine.pays, 0, sizeof(machine.pays));
+    machine.reelCount = static_cast<int>(config.strips.size());
+    machine.lineCount = static_cast<int>(config.paylines.size());
+    for (int reel = 0; reel < machine.reelCount; ++reel) {
+        const std::vector<int>& strip = config.strips[reel];
+        machine.stripLengths[reel] = static_cast<int>(strip.size());
+        for (size_t i = 0; i < strip.size() + config.rows - 1; ++i) {
+            machine.strips[reel].push_back(static_cast<uint8_t>(strip[i % strip.size()]));
+        }
+    }
+    for (int line = 0; line < machine.lineCount; ++line) {
+        for (int reel = 0; reel < machine.reelCount; ++reel) {
+            machine.lines[line][reel] = static_cast<uint8_t>(config.paylines[line][reel]);
+        }
+    }
+    for (size_t symbol = 0; symbol < config.pays.size(); ++symbol) {
+        for (size_t count = 0; count < config.pays[symbol].size(); ++count) {
+            machine.pays[symbol][count] = config.pays[symbol][count];
+        }
+    }
+}
+
+/**
+ * The per-line loop: the run of the leftmost symbol of each line, one line at
+ * a time. The benchmark baseline.
+ * @param machine The tables.
+ * @param stops The stop of each reel.
+ * @return The total win in line bets.
+ */
+static uint32_t evaluateReference(const ReferenceMachine& machine, const int* stops) {
+    const uint8_t* windows[MachineConfig::MAX_REELS];
+    for (int reel = 0; reel < machine.reelCount; ++reel) {
+        windows[reel] = machine.strips[reel].data() + stops[reel];
+    }
+    uint32_t total = 0;
+    for (int line = 0; line < machine.lineCount; ++line) {
+        const uint8_t* rows = machine.lines[line];
+        int symbol = windows[0][rows[0]];
+        int count = 1;
+        while (count < machine.reelCount && windows[count][rows[count]] == symbol) {
+            ++count;
+        }
+        total += machine.pays[symbol][count];
+    }
+    return total;
+}
+
+/**
+ * Gets the time since a start point.
+ * @param start The start point.
+ * @return The elapsed time in seconds.
+ */
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * Times payline evaluation on one thread: the per-line loop the engine used
+ * before, against every kernel the CPU supports. Each is measured from
+ * stops, from windows already in batches, and from the random stream
+ * including the draws. Every kernel must match the per-line loop's total.
+ * @param config The machine; must pay left to right only, without a wild.
+ * @param seed The seed of the stops.
+ * @return True if every kernel matched, false otherwise.
+ */
+static bool runBenchmark(const MachineConfig& config, uint64_t seed) {
+    ReferenceMachine machine;
+    buildReference(config, machine);
+    int reelCount = machine.reelCount;
+
+    Random random(seed);
+    std::vector<int> stops(static_cast<size_t>(BENCHMARK_SPINS) * reelCount);
+    for (int spin = 0; spin < BENCHMARK_SPINS; ++spin) {
+        for (int reel = 0; reel < reelCount; ++reel) {
+            stops[spin * reelCount + reel] = static_cast<int>(random.nextBounded(static_cast<uint32_t>(machine.stripLengths[reel])));
+        }
+    }
+    std::vector<WindowBatch> batches(BENCHMARK_SPINS / WindowBatch::SIZE);
+    for (int spin = 0; spin < BENCHMARK_SPINS; ++spin) {
+        WindowBatch& batch = batches[spin / WindowBatch::SIZE];
+        batch.count = WindowBatch::SIZE;
+        for (int reel = 0; reel < reelCount; ++reel) {
+            for (int row = 0; row < config.rows; ++row) {
+                batch.cells[reel][row][spin % WindowBatch::SIZE] = machine.strips[reel][stops[spin * reelCount + reel] + row];
+            }
+        }
+    }
+    double windows = static_cast<double>(BENCHMARK_SPINS) * BENCHMARK_ROUNDS;
+    printf("Benchmark: %d windows x %d rounds on one thread, seed %llu\n", BENCHMARK_SPINS, BENCHMARK_ROUNDS,
+        static_cast<unsigned long long>(seed));
+
+    // Baseline, from stops and from the random stream
+    uint64_t expected = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        for (int spin = 0; spin < BENCHMARK_SPINS; ++spin) {
+            expected += evaluateReference(machine, &stops[spin * reelCount]);
+        }
+    }
+    double referenceRate = windows / secondsSince(start);
+
+    Random spinRandom(seed);
+    uint64_t spinTotal = 0;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+        for (int spin = 0; spin < BENCHMARK_SPINS; ++spin) {
+            int drawn[MachineConfig::MAX_REELS];
+            for (int reel = 0; reel < reelCount; ++reel) {
+                drawn[reel] = static_cast<int>(spinRandom.nextBounded(static_cast<uint32_t>(machine.stripLengths[reel])));
+            }
+            spinTotal += evaluateReference(machine, drawn);
+        }
+    }
+    double referenceSpinRate = windows / secondsSince(start);
+
+    printf("\nKernel             Stops -> win   Batch -> win   Spins -> win   (M/s)\n");
+    printf("per-line loop      %12.1f   %12s   %12.1f\n", referenceRate / 1e6, "-", referenceSpinRate / 1e6);
+
+    const PaylineEvaluator::Kernel kernels[] = {
+        PaylineEvaluator::KERNEL_SCALAR, PaylineEvaluator::KERNEL_SSE41, PaylineEvaluator::KERNEL_AVX2
+    };
+    std::vector<uint32_t> wins(BENCHMARK_SPINS);
+    bool matched = true;
+    for (PaylineEvaluator::Kernel kernel : kernels) {
+        OutcomeEngine engine(config);
+        PaylineEvaluator evaluator(config);
+        if (!engine.setKernel(kernel) || !evaluator.setKernel(kernel)) {
+            continue;
+        }
+        LineCounts counts = {};
+
+        uint64_t total = 0;
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+            engine.evaluateWins(stops.data(), BENCHMARK_SPINS, wins.data(), &counts);
+            for (int spin = 0; spin < BENCHMARK_SPINS; ++spin) {
+                total += wins[spin];
+            }
+        }
+        double stopsRate = windows / secondsSince(start);
+
+        uint64_t batchTotal = 0;
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+            for (size_t i = 0; i < batches.size(); ++i) {
+                evaluator.evaluateBatch(batches[i], wins.data(), &counts);
+                for (int window = 0; window < WindowBatch::SIZE; ++window) {
+                    batchTotal += wins[window];
+                }
+            }
+        }
+        double batchRate = windows / secondsSince(start);
+
+        Random kernelRandom(seed);
+        uint64_t kernelSpinTotal = 0;
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < BENCHMARK_ROUNDS; ++round) {
+            engine.spinWins(kernelRandom, BENCHMARK_SPINS, wins.data(), &counts);
+            for (int spin = 0; spin < BENCHMARK_SPINS; ++spin) {
+                kernelSpinTotal += wins[spin];
+            }
+        }
+        double spinRate = windows / secondsSince(start);
+
+        printf("%-18s %12.1f   %12.1f   %12.1f   (%.1fx / %.1fx the per-line loop)\n", PaylineEvaluator::getKernelName(kernel),
+            stopsRate / 1e6, batchRate / 1e6, spinRate / 1e6, stopsRate / referenceRate, spinRate / referenceSpinRate);
+        if (total != expected || batchTotal != expected || kernelSpinTotal != spinTotal) {
+            printf("Kernel %s does not match the per-line loop!\n", PaylineEvaluator::getKernelName(kernel));
+            matched = false;
+        }
+    }
+    return matched;
+}
+
+// Random machines the kernels are checked on, and the most spins drawn on each
+static const int VERIFY_MACHINES = 3000;
+static const int VERIFY_MAX_SPINS = 300;
+
+/**
+ * Builds a random valid machine: any reel, row, line and symbol count within
+ * the limits, sparse pays that sometimes reach MAX_PAY, and a wild and
+ * both-way pays half the time each.
+ * @param random The random stream to draw from.
+ * @param config Receives the machine.
+ */
+static void buildRandomMachine(Random& random, MachineConfig& config) {
+    int reelCount = random.nextInt(1, MachineConfig::MAX_REELS);
+    int symbolCount = random.nextInt(1, MachineConfig::MAX_SYMBOLS);
+    int lineCount = random.nextInt(1, MachineConfig::MAX_PAYLINES);
+    config.rows = random.nextInt(1, MachineConfig::MAX_ROWS);
+    config.strips.assign(reelCount, std::vector<int>());
+    for (std::vector<int>& strip : config.strips) {
+        strip.resize(random.nextInt(config.rows, config.rows + 20));
+        for (int& symbol : strip) {
+            symbol = random.nextInt(0, symbolCount - 1);
+        }
+    }
+    config.paylines.assign(lineCount, std::vector<int>(reelCount));
+    for (std::vector<int>& line : config.paylines) {
+        for (int& row : line) {
+            row = random.nextInt(0, config.rows - 1);
+        }
+    }
+    config.pays.assign(symbolCount, std::vector<uint32_t>(reelCount + 1, 0));
+    for (std::vector<uint32_t>& symbolPays : config.pays) {
+        for (int count = 1; count <= reelCount; ++count) {
+            int kind = random.nextInt(0, 15);
+            if (kind == 0) {
+                symbolPays[count] = MachineConfig::MAX_PAY;
+            }
+            else if (kind < 6) {
+                symbolPays[count] = random.nextBounded(1000);
+            }
+        }
+    }
+    config.wild = random.nextInt(0, 1) == 0 ? random.nextInt(0, symbolCount - 1) : -1;
+    config.bothWays = random.nextInt(0, 1) == 0;
+}
+
+/**
+ * Checks every kernel the CPU supports against OutcomeEngine::evaluate on
+ * random machines, covering wilds, both-way pays and every reel count. Each
+ * kernel's total wins, with and without line counts, and its line counts must
+ * match the wins evaluate lists spin by spin.
+ * @param seed The seed of the machines and stops.
+ * @return True if every kernel matched, false otherwise.
+ */
+static bool runVerify(uint64_t seed) {
+    const PaylineEvaluator::Kernel kernels[] = {
+        PaylineEvaluator::KERNEL_SCALAR, PaylineEvaluator::KERNEL_SSE41, PaylineEvaluator::KERNEL_AVX2
+    };
+    printf("Verifying the payline kernels on %d random machines, seed %llu\n", VERIFY_MACHINES,
+        static_cast<unsigned long long>(seed));
+
+    Random random(seed);
+    int mismatches = 0;
+    for (int machine = 0; machine < VERIFY_MACHINES; ++machine) {
+        MachineConfig config;
+        buildRandomMachine(random, config);
+        if (!config.isValid()) {
+            return false;
+        }
+        OutcomeEngine engine(config);
+        int reelCount = engine.getReelCount();
+        int spinCount = random.nextInt(1, VERIFY_MAX_SPINS);
+        std::vector<int> stops(static_cast<size_t>(spinCount) * reelCount);
+        for (int spin = 0; spin < spinCount; ++spin) {
+            for (int reel = 0; reel < reelCount; ++reel) {
+                stops[spin * reelCount + reel] = static_cast<int>(random.nextBounded(static_cast<uint32_t>(engine.getStripLength(reel))));
+            }
+        }
+
+        std::vector<uint32_t> expected(spinCount);
+        LineCounts expectedCounts = {};
+        for (int spin = 0; spin < spinCount; ++spin) {
+            SpinResult result;
+            engine.evaluate(&stops[spin * reelCount], result);
+            expected[spin] = result.totalWin;
+            for (int i = 0; i < result.winCount; ++i) {
+                ++expectedCounts.lines[result.wins[i].symbol][result.wins[i].count];
+            }
+        }
+
+        for (PaylineEvaluator::Kernel kernel : kernels) {
+            if (!engine.setKernel(kernel)) {
+                continue;
+            }
+            std::vector<uint32_t> wins(spinCount);
+            std::vector<uint32_t> uncounted(spinCount);
+            LineCounts counts = {};
+            engine.evaluateWins(stops.data(), spinCount, wins.data(), &counts);
+            engine.evaluateWins(stops.data(), spinCount, uncounted.data(), nullptr);
+            if (wins != expected || uncounted != expected || memcmp(&counts, &expectedCounts, sizeof(counts)) != 0) {
+                printf("Kernel %s does not match on machine %d: %d reels, %d lines, wild %d, %s!\n",
+                    PaylineEvaluator::getKernelName(kernel), machine, reelCount, engine.getLineCount(), config.wild,
+                    config.bothWays ? "both ways" : "left to right");
+                ++mismatches;
+            }
+        }
+    }
+
+    printf("%d mismatches\n", mismatches);
+    return mismatches == 0;
+}
+
+/**
+ * Selects the payline kernel named on the command line.
+ * @param engine The engine to configure.
+ * @param name The kernel name, as printed by PaylineEvaluator::getKernelName.
+ * @return True if the kernel is in use, false if it is unknown or unsupported.
+ */
+static bool selectKernel(OutcomeEngine& engine, const char* name) {
+    const PaylineEvaluator::Kernel kernels[] = {
+        PaylineEvaluator::KERNEL_SCALAR, PaylineEvaluator::KERNEL_SSE41, PaylineEvaluator::KERNEL_AVX2
+    };
+    for (PaylineEvaluator::Kernel kernel : kernels) {
+        if (strcmp(name, PaylineEvaluator::getKernelName(kernel)) == 0) {
+            if (!engine.setKernel(kernel)) {
+                printf("Payline kernel %s is not supported by this CPU!\n", name);
+                return false;
+            }
+            return true;
+        }
+    }
+    printf("Unknown payline kernel %s!\n", name);
+    return false;
+}
+
+/**
+ * Runs Monte Carlo spins of the classic machine on all cores and reports its
+ * return to player, hit rate, volatility and line frequencies. With --exact,
+ * walks the full reel cycle instead and reports the exact values.
+ * --kernel forces a payline kernel instead of the best one the CPU supports.
+ * --benchmark times every kernel against the old per-line loop instead, and
+ * --verify checks every kernel on random machines.
+ * Usage: RtpSimulator [--spins <n>] [--threads <n>] [--seed <n>] [--exact | --benchmark | --verify] [--kernel scalar|SSE4.1|AVX2]
+ */
+int main(int argc, char* argv[]) {
+    uint64_t spinCount = 100000000;
+    unsigned threadCount = std::thread::hardware_concurrency();
+    uint64_t seed = Random::makeSeed();
+    bool exact = false;
+    bool benchmark = false;
+    bool verify = false;
+    const char* kernelName = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        uint64_t value = 0;
+        if (strcmp(argv[i], "--spins") == 0 && i + 1 < argc && parseCount(argv[i + 1], value)) {
+            spinCount = value;
+            ++i;
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc && parseCount(argv[i + 1], value)) {
+            threadCount = static_cast<unsigned>(value);
+            ++i;
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[i + 1], nullptr, 10);
+            ++i;
+        }
+        else if (strcmp(argv[i], "--exact") == 0) {
+            exact = true;
+        }
+        else if (strcmp(argv[i], "--benchmark") == 0) {
+            benchmark = true;
+        }
+        else if (strcmp(argv[i], "--verify") == 0) {
+            verify = true;
+        }
+        else if (strcmp(argv[i], "--kernel") == 0 && i + 1 < argc) {
+            kernelName = argv[i + 1];
+            ++i;
+        }
+        else {
+            printf("Usage: %s [--spins <n>] [--threads <n>] [--seed <n>] [--exact | --benchmark | --verify] [--kernel scalar|SSE4.1|AVX2]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+
+    MachineConfig config = MachineConfig::createClassic();
+    if (!config.isValid()) {
+        printf("Invalid machine configuration!\n");
+        return 1;
+    }
+    if (benchmark) {
+        return runBenchmark(config, seed) ? 0 : 1;
+    }
+    if (verify) {
+        return runVerify(seed) ? 0 : 1;
+    }
+    OutcomeEngine engine(config);
+    if (kernelName != nullptr && !selectKernel(engine, kernelName)) {
+        return 1;
+    }
+    printf("Payline kernel: %s\n", PaylineEvaluator::getKernelName(engine.getKernel()));
+    if (exact) {
+        return runExact(engine, threadCount) ? 0 : 1;
+    }
+
+    printf("Simulating %llu spins on %u threads, seed %llu\n", static_cast<unsigned long long>(spinCount), threadCount,
+        static_cast<unsigned long long>(seed));
+
+    // Each worker gets its own stream 2^128 values apart, so no two ever overlap
+    Random random(seed);
+    std::vector<SpinStats> results(threadCount);
+    std::vector<WorkerProgress> progress(threadCount);
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < threadCount; ++i) {
+        progress[i].spins.store(0, std::memory_order_relaxed);
+        uint64_t share = spinCount / threadCount + (i < spinCount % threadCount ? 1 : 0);
+        try {
+            workers.emplace_back(runWorker, std::cref(engine), random.split(), share, std::ref(progress[i]), std::ref(results[i]));
+        }
+        catch (const std::system_error& e) {
+            printf("Worker thread could not be started! Error: %s\n", e.what());
+            for (std::thread& worker : workers) {
+                worker.join();
+            }
+            return 1;
+        }
+    }
+
+    // The workers never wait on each other; the counters are only read here
+    uint64_t done = 0;
+    int polls = 0;
+    while (done < spinCount) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        done = 0;
+        for (const WorkerProgress& worker : progress) {
+            done += worker.spins.load(std::memory_order_relaxed);
+        }
+        if (++polls % 10 == 0 || done == spinCount) {
+            double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            printf("\r%6.2f%%  %.0f spins/s    ", 100.0 * done / spinCount, done / elapsed);
+            fflush(stdout);
+        }
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    // Workers started within microseconds of each other, so the slowest one is the wall time
+    SpinStats total = {};
+    double seconds = 0.0;
+    for (const SpinStats& stats : results) {
+        mergeStats(total, stats);
+        seconds = std::max(seconds, stats.seconds);
+    }
+    printReport(engine, total, seconds, threadCount);
+    return 0;
+}
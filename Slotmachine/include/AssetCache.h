@@ -0,0 +1,68 @@
+#ifndef ASSETCACHE_H
+#define ASSETCACHE_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include "Renderer.h"
+
+class AssetCache {
+public:
+    // Shared handles; the asset is freed when the last handle is released
+    typedef std::shared_ptr<SDL_Texture> TextureHandle;
+    typedef std::shared_ptr<TTF_Font> FontHandle;
+    typedef std::shared_ptr<Mix_Chunk> SoundHandle;
+
+    // Resident memory of a single cached asset
+    struct AssetInfo {
+        std::string key;
+        std::string type;
+        size_t bytes;
+        long refs;
+    };
+
+    AssetCache(std::shared_ptr<Renderer> renderer);
+    ~AssetCache();
+
+    // Loads each file once; later calls with the same path share the handle
+    TextureHandle getTexture(const std::string& path);
+    FontHandle getFont(const std::string& path, int size);
+    SoundHandle getSound(const std::string& path);
+
+    // Takes ownership of an asset created elsewhere so it shows up in the report
+    TextureHandle adoptTexture(const std::string& key, SDL_Texture* texture);
+    SoundHandle adoptSound(const std::string& key, Mix_Chunk* chunk);
+
+    // Memory reporting
+    std::vector<AssetInfo> getResidentAssets() const;
+    size_t getResidentBytes() const;
+    void printReport() const;
+
+    // Drops entries whose handles have all been released
+    void purge();
+
+private:
+    template <typename T>
+    struct Entry {
+        std::weak_ptr<T> handle;
+        size_t bytes;
+    };
+
+    static size_t textureBytes(SDL_Texture* texture);
+    static size_t fileBytes(const std::string& path);
+
+    std::shared_ptr<Renderer> mRenderer;
+    std::map<std::string, Entry<SDL_Texture>> mTextures;
+    std::map<std::string, Entry<TTF_Font>> mFonts;
+    std::map<std::string, Entry<Mix_Chunk>> mSounds;
+
+    // Prevent copying
+    AssetCache(const AssetCache&) = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+};
+
+#endif // ASSETCACHE_H
@@ -0,0 +1,93 @@
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "Renderer.h"
+#include "AssetCache.h"
+#include "AssetPack.h"
+
+// Decodes images and sounds on a pool of worker threads. Only the texture
+// uploads run on the calling thread, which also reports progress while waiting.
+// Files found in an asset pack skip decoding and are uploaded from the mapping.
+// Loaded assets are registered in the AssetCache under their file path and kept
+// alive until the loader is destroyed, so later getTexture/getSound calls hit the cache.
+class AssetLoader {
+public:
+    // Called on the loading thread with the number of finished and total files
+    typedef std::function<void(int completed, int total)> ProgressCallback;
+
+    AssetLoader(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets);
+    ~AssetLoader();
+
+    // Queues a file; call before load()
+    void addTexture(const std::string& path); // Uploaded to a texture in the cache
+    void addSurface(const std::string& path); // Kept on the CPU for takeSurface
+    void addSound(const std::string& path);   // Registered as a sound in the cache
+
+    // Pre-decoded pack to try before the loose files; may be null
+    void setPack(std::shared_ptr<AssetPack> pack);
+
+    // Decodes all queued files; workerCount 0 uses one thread per spare core.
+    // Returns false if any file failed to load.
+    bool load(const ProgressCallback& progress, int workerCount = 0);
+
+    // Hands over a surface queued with addSurface; the caller frees it. Returns nullptr if missing.
+    // Surfaces from a pack are premultiplied and only valid while the pack is alive.
+    SDL_Surface* takeSurface(const std::string& path, bool* premultiplied = nullptr);
+
+private:
+    enum JobType {
+        JOB_TEXTURE,
+        JOB_SURFACE,
+        JOB_SOUND
+    };
+
+    struct Job {
+        JobType type;
+        std::string path;
+        SDL_Surface* surface;
+        Mix_Chunk* chunk;
+    };
+
+    struct LoadedSurface {
+        SDL_Surface* surface;
+        bool premultiplied;
+    };
+
+    void workerMain();
+    bool finishJob(Job& job);
+    bool loadFromPack(Job& job);
+
+    std::shared_ptr<Renderer> mRenderer;
+    std::shared_ptr<AssetCache> mAssets;
+    std::shared_ptr<AssetPack> mPack;
+    std::vector<Job> mJobs;
+
+    // Shared with the workers
+    std::vector<size_t> mPending; // Jobs that need decoding
+    std::atomic<size_t> mNextJob;
+    std::mutex mMutex;
+    std::condition_variable mJobDone;
+    std::vector<size_t> mCompleted; // Decoded jobs waiting to be finished on the loading thread
+
+    // Results
+    std::vector<AssetCache::TextureHandle> mTextures;
+    std::vector<AssetCache::SoundHandle> mSounds;
+    std::map<std::string, LoadedSurface> mSurfaces;
+
+    // Prevent copying
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+};
+
+#endif // ASSETLOADER_H
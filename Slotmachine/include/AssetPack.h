@@ -0,0 +1,40 @@
+#ifndef ASSETPACK_H
+#define ASSETPACK_H
+
+#include <SDL.h>
+#include <SDL_mixer.h>
+#include <string>
+#include <map>
+#include "AssetPackFormat.h"
+#include "MappedFile.h"
+
+// Runtime view of an asset pack written by the AssetPacker tool. The pack is
+// memory-mapped; surfaces and sounds created from it point into the mapping,
+// so the pack must outlive them.
+class AssetPack {
+public:
+    AssetPack();
+    ~AssetPack();
+
+    // Maps the pack and validates its header and index
+    bool open(const std::string& path);
+
+    // Looks up an asset by the path it was packed from; nullptr if absent
+    const AssetPackEntry* find(const std::string& name) const;
+    const Uint8* getData(const AssetPackEntry& entry) const;
+    size_t getEntryCount() const;
+
+    // Wraps pixels or PCM in the mapping without copying; nullptr on a type or format mismatch
+    SDL_Surface* createSurface(const AssetPackEntry& entry) const;
+    Mix_Chunk* createChunk(const AssetPackEntry& entry) const;
+
+private:
+    MappedFile mFile;
+    std::map<std::string, const AssetPackEntry*> mIndex;
+
+    // Prevent copying
+    AssetPack(const AssetPack&) = delete;
+    AssetPack& operator=(const AssetPack&) = delete;
+};
+
+#endif // ASSETPACK_H
@@ -0,0 +1,71 @@
+#ifndef ASSETPACKFORMAT_H
+#define ASSETPACKFORMAT_H
+
+#include <SDL.h>
+
+// On-disk layout of an asset pack, shared by the game and the AssetPacker tool.
+// A pack is a header, the asset blobs, and an index of entries at indexOffset.
+// All fields are little-endian.
+
+const Uint32 ASSET_PACK_MAGIC = 0x4B435041; // "APCK"
+const Uint32 ASSET_PACK_VERSION = 1;
+
+enum {
+    ASSET_PACK_DATA_ALIGNMENT = 4096, // Every blob starts on a page boundary
+    ASSET_PACK_ROW_ALIGNMENT = 64,    // Texture rows start on a cache line
+    ASSET_PACK_NAME_LENGTH = 104
+};
+
+enum AssetPackType {
+    ASSET_PACK_TEXTURE = 1, // Premultiplied ARGB8888 pixels, ready for SDL_UpdateTexture
+    ASSET_PACK_SOUND = 2    // PCM in the mixer's output format, ready for Mix_QuickLoad_RAW
+};
+
+struct AssetPackHeader {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 entryCount;
+    Uint32 entrySize;   // sizeof(AssetPackEntry), guards against layout changes
+    Uint64 indexOffset;
+};
+
+struct AssetPackEntry {
+    char name[ASSET_PACK_NAME_LENGTH]; // Path the asset was packed from, NUL-terminated
+    Uint32 type;
+    Uint32 format; // SDL pixel format or SDL audio format
+    Uint32 width;  // Texture width, or sound frequency
+    Uint32 height; // Texture height, or sound channel count
+    Uint32 pitch;  // Bytes per texture row, 0 for sounds
+    Uint32 reserved;
+    Uint64 offset;
+    Uint64 size;
+};
+
+static_assert(sizeof(AssetPackHeader) == 24, "AssetPackHeader layout changed");
+static_assert(sizeof(AssetPackEntry) == 144, "AssetPackEntry layout changed");
+
+// Multiplies the color channels of an ARGB8888 surface by its alpha, in place.
+// Returns false if the surface has another format.
+inline bool premultiplyAlpha(SDL_Surface* surface) {
+    if (surface == nullptr || surface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        return false;
+    }
+    Uint8* row = static_cast<Uint8*>(surface->pixels);
+    for (int y = 0; y < surface->h; ++y, row += surface->pitch) {
+        Uint32* pixel = reinterpret_cast<Uint32*>(row);
+        for (int x = 0; x < surface->w; ++x) {
+            Uint32 p = pixel[x];
+            Uint32 a = p >> 24;
+            if (a == 255) {
+                continue;
+            }
+            Uint32 r = (((p >> 16) & 0xFF) * a + 127) / 255;
+            Uint32 g = (((p >> 8) & 0xFF) * a + 127) / 255;
+            Uint32 b = ((p & 0xFF) * a + 127) / 255;
+            pixel[x] = (a << 24) | (r << 16) | (g << 8) | b;
+        }
+    }
+    return true;
+}
+
+#endif // ASSETPACKFORMAT_H
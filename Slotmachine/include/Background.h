@@ -4,19 +4,21 @@
 
 #include <string>
 #include <Renderer.h>
+#include "AssetCache.h"
 #include <memory>
 
 
 class Background {
 public:
-    Background(std::shared_ptr<Renderer> renderer);
+    Background(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets);
     ~Background();
     bool loadMedia(const std::string& path);
     void render();
 
 private:
     std::shared_ptr<Renderer> mRenderer;
-    SDL_Texture* mTexture;
+    std::shared_ptr<AssetCache> mAssets;
+    AssetCache::TextureHandle mTexture;
 };
 
 #endif // BACKGROUND_H
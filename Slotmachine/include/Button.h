@@ -5,15 +5,21 @@
 #include <string>
 #include <SDL_mixer.h>
 #include "Renderer.h"
+#include "TextRenderer.h"
+#include "AssetCache.h"
+#include "FrameClock.h"
 #include <memory>
 
 
 class Button {
 public:
-    Button(std::shared_ptr<Renderer> renderer, int x, int y, int w, int h, const std::string& text);
+    Button(std::shared_ptr<Renderer> renderer, std::shared_ptr<TextRenderer> textRenderer, std::shared_ptr<AssetCache> assets, int x, int y, int w, int h, const std::string& text);
     ~Button();
 
+    void update(const FrameClock& clock);
     void render();
+    const SDL_Rect& getRect() const;
+    Uint32 getMsUntilNextChange(const FrameClock& clock) const; // Time until the button's appearance changes by itself
     void handleEvent(const SDL_Event& e);
     bool isClicked() const;
     void resetClick();
@@ -21,12 +27,14 @@ public:
 
 private:
     std::shared_ptr<Renderer> mRenderer;  // Changed to std::shared_ptr
+    std::shared_ptr<TextRenderer> mTextRenderer;
     SDL_Rect mButtonRect;
     std::string mText;
+    TextRenderer::TextId mTextId; // Cached layout of mText
     bool mHighlighted;
     bool mClicked;
     bool mActive; // variable to track active state
-    Uint32 mAnimationStartTime;
+    double mAnimationStartTime; // Frame clock time of the last color change, in milliseconds
     const Uint32 mAnimationDuration = 500; // Duration in milliseconds
 
     SDL_Color mBaseColor;
@@ -34,12 +42,12 @@ private:
     SDL_Color mInactiveColor; // Color for inactive state
     SDL_Color mCurrentColor;
 
-    void renderText(const std::string& text, int x, int y);
-    void animate();
+    void renderText();
+    void animate(double now);
     void setColor(const SDL_Color& color);
     void playClickSound(); // method to play sound
 
-    Mix_Chunk* mClickSound; // for sound effect
+    AssetCache::SoundHandle mClickSound; // for sound effect, shared through the AssetCache
 };
 
 #endif
@@ -4,4 +4,12 @@
 const int SCREEN_WIDTH = 900;
 const int SCREEN_HEIGHT = 600;
 
+// Frame pacing defaults
+const int TARGET_FRAME_RATE = 60;
+const bool USE_VSYNC = true;
+const double SIMULATION_STEP_MS = 1000.0 / 240.0; // Fixed reel simulation step
+
+// Profiler output, written on F9 and on exit while profiling is enabled
+const char* const PROFILE_TRACE_PATH = "profile_trace.json";
+
 #endif // CONSTANTS_H
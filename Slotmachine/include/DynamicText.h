@@ -0,0 +1,48 @@
+#ifndef DYNAMICTEXT_H
+#define DYNAMICTEXT_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <memory>
+#include "Renderer.h"
+
+// Single line of text that changes often, such as a counter or a meter.
+// The text is uploaded into one streaming texture that is only recreated
+// when the text outgrows it, so updates do not allocate GPU objects.
+class DynamicText {
+public:
+    DynamicText(std::shared_ptr<Renderer> renderer, TTF_Font* font);
+    ~DynamicText();
+
+    // Re-renders the text; does nothing if neither the text nor the color changed
+    bool setText(const std::string& text, SDL_Color color);
+
+    void render(int x, int y);
+    int getWidth() const;
+    int getHeight() const;
+
+private:
+    enum {
+        MIN_TEXTURE_WIDTH = 64,  // Widths grow in powers of two from here
+        HEIGHT_BUCKET = 16       // Heights grow in steps of this
+    };
+
+    bool reserve(int width, int height);
+
+    std::shared_ptr<Renderer> mRenderer;
+    TTF_Font* mFont;
+    SDL_Texture* mTexture;
+    int mTextureWidth;
+    int mTextureHeight;
+    int mWidth;  // Size of the current text inside the texture
+    int mHeight;
+    std::string mText;
+    SDL_Color mColor;
+
+    // Prevent copying
+    DynamicText(const DynamicText&) = delete;
+    DynamicText& operator=(const DynamicText&) = delete;
+};
+
+#endif // DYNAMICTEXT_H
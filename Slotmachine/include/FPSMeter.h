@@ -4,24 +4,67 @@
 #include "Renderer.h"
 #include <SDL_ttf.h>
 #include <string>
-#include "LTexture.h"
+#include "DynamicText.h"
+#include "FrameTimeHistogram.h"
+#include "FrameClock.h"
 #include <memory>
 
+// Frame time statistics in milliseconds
+struct FrameStats {
+    Uint64 frameCount;
+    double averageMs;
+    double p50Ms;
+    double p95Ms;
+    double p99Ms;
+    double maxMs;
+};
 
 class FPSMeter {
 public:
-    FPSMeter(std::shared_ptr<Renderer> renderer, TTF_Font* font);
+    FPSMeter(std::shared_ptr<Renderer> renderer, TTF_Font* font, TTF_Font* detailFont);
     ~FPSMeter();
-    void start();
-    void update();
+    void start(const FrameClock& clock);
+    void update(const FrameClock& clock); // Call once per frame
+    void resume(); // Call after an idle wait so the wait is not counted as a frame
     void render(int x, int y);
+    Uint32 getMsUntilNextUpdate(const FrameClock& clock) const; // Time until the displayed value changes
+
+    // Renderer call counts and a graph of the most recent frame times above the text
+    void setDetailsVisible(bool visible);
+    bool isDetailsVisible() const;
+
+    // Frame times since start()
+    FrameStats getStats() const;
+    void printStats() const;
 
 private:
+    enum {
+        GRAPH_SAMPLES = 120,   // Frames shown in the graph
+        GRAPH_BAR_WIDTH = 2,
+        GRAPH_HEIGHT = 60,
+        GRAPH_RANGE_MS = 50,   // Frame time at the top of the graph
+        LINE_SPACING = 2
+    };
+
+    SDL_Rect getBounds() const;      // Area covered by the text and the details
+    SDL_Rect getGraphRect() const;
+    int getCountersY() const;
+    void renderGraph(const SDL_Rect& rect);
+
     std::shared_ptr<Renderer> mRenderer;  // Pointer to the custom Renderer class
-    TTF_Font* gFont;      // Pointer to the TTF_Font
     int frameCount;
-    Uint32 startTime;
-    LTexture fpsTexture;
+    double startTime; // Frame clock time when the current second started, in milliseconds
+    DynamicText fpsTexture;
+    DynamicText statsTexture; // Percentiles, drawn above the FPS line
+    DynamicText countersTexture; // Renderer calls of the last frame, drawn above the percentiles
+    SDL_Point mPosition;   // Where the FPS line is rendered
+    SDL_Rect mLastRect;    // Area last drawn
+
+    FrameTimeHistogram mHistogram; // Frame times in microseconds since start()
+    Uint64 mLastFrameCounter;      // Frame clock counter at the last update, or 0 after a pause
+    float mGraphMs[GRAPH_SAMPLES]; // Ring of recent frame times
+    int mGraphNext;
+    bool mDetailsVisible;
 };
 
 #endif // FPSMETER_H
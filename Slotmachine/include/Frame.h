@@ -3,13 +3,14 @@
 
 #include <string>
 #include "Renderer.h"  // Include the custom Renderer class
+#include "AssetCache.h"
 #include <memory>
 
 
 class Frame {
 public:
     // Constructor and Destructor
-    Frame(std::shared_ptr<Renderer> renderer, int borderWidth = 1);  // Use custom Renderer class
+    Frame(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets, int borderWidth = 1);  // Use custom Renderer class
     ~Frame();
 
     // Set the dimensions of the frame
@@ -42,11 +43,12 @@ private:
     void drawHeader();
 
     std::shared_ptr<Renderer> mRenderer;      // Pointer to the custom Renderer class
+    std::shared_ptr<AssetCache> mAssets;      // Shared texture cache
     SDL_Rect mRect;           // Rectangle defining the main frame
     int mBorderWidth;         // Border width of the frame
     int mBottomHeight;        // Height of the bottom section
-    SDL_Texture* mBottomTexture;  // Texture for the bottom section
-    SDL_Texture* mHeaderTexture;  // Texture for the header section
+    AssetCache::TextureHandle mBottomTexture;  // Texture for the bottom section
+    AssetCache::TextureHandle mHeaderTexture;  // Texture for the header section
 };
 
 #endif // FRAME_H
@@ -0,0 +1,30 @@
+#ifndef FRAMECLOCK_H
+#define FRAMECLOCK_H
+
+#include <SDL.h>
+
+// Monotonic clock on the performance counter, sampled once per frame so every
+// subsystem sees the same "now" within a frame and at sub-millisecond resolution.
+class FrameClock {
+public:
+    FrameClock();
+
+    // Samples the performance counter; call once at the start of each frame
+    void tick();
+
+    // Counter value at the last tick, comparable with SDL_GetPerformanceCounter
+    Uint64 getCounter() const;
+
+    // Time of the last tick since the clock was created
+    double getMs() const;
+
+    // Converts a difference of counter values to milliseconds
+    double toMs(Uint64 counterDelta) const;
+
+private:
+    Uint64 mFrequency;
+    Uint64 mOrigin;
+    Uint64 mCounter;
+};
+
+#endif // FRAMECLOCK_H
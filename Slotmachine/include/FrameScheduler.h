@@ -0,0 +1,62 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <SDL.h>
+
+class FrameScheduler {
+public:
+    // A simulation step of 0 only paces frames and never accumulates time
+    FrameScheduler(double simulationStepMs, int targetFrameRate);
+
+    // Target frame rate used when vsync does not pace the loop; 0 means unlimited
+    void setTargetFrameRate(int framesPerSecond);
+
+    // With vsync a presented frame is already paced by the display
+    void setVSync(bool enabled);
+
+    // Starts a frame and adds the elapsed time to the simulation accumulator;
+    // now is the performance counter at the frame start if already sampled
+    void beginFrame();
+    void beginFrame(Uint64 now);
+
+    // Consumes one fixed simulation step; call until it returns false
+    bool stepSimulation();
+
+    // Sleeps and yields for the rest of the frame budget, then measures the deadline error
+    void endFrame(bool presented);
+
+    // Drops accumulated time, e.g. after the loop was blocked
+    void reset();
+
+    // Pacing statistics
+    double getFrameTimeMs() const;        // Duration of the last frame
+    double getDeadlineErrorMs() const;    // Last frame end minus its deadline; positive is late
+    double getMaxDeadlineErrorMs() const;
+    double getMeanDeadlineErrorMs() const; // Mean absolute error
+    Uint64 getFrameCount() const;
+    Uint64 getMissedDeadlines() const;
+    void printStats() const;
+
+private:
+    double toMs(Uint64 counter) const;
+    Uint64 fromMs(double ms) const;
+
+    Uint64 mFrequency;
+    Uint64 mStepCounts;        // Simulation step in performance counter ticks, 0 if pacing only
+    Uint64 mFramePeriod;       // Frame budget in ticks, 0 if unlimited
+    bool mVSync;
+
+    Uint64 mFrameStart;
+    Uint64 mLastFrameStart;
+    Uint64 mDeadline;
+    Uint64 mAccumulator;
+
+    double mFrameTimeMs;
+    double mDeadlineErrorMs;
+    double mMaxDeadlineErrorMs;
+    double mDeadlineErrorSumMs;
+    Uint64 mFrameCount;
+    Uint64 mMissedDeadlines;
+};
+
+#endif // FRAMESCHEDULER_H
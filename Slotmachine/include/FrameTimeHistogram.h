@@ -0,0 +1,42 @@
+#ifndef FRAMETIMEHISTOGRAM_H
+#define FRAMETIMEHISTOGRAM_H
+
+#include <SDL.h>
+
+// Log-linear histogram of durations in microseconds, in the style of HdrHistogram:
+// every power of two is split into SUB_BUCKETS / 2 linear buckets, so any recorded
+// value is reported within about 3% while the memory stays fixed.
+class FrameTimeHistogram {
+public:
+    FrameTimeHistogram();
+
+    void record(Uint64 microseconds);
+    void reset();
+
+    Uint64 getCount() const;
+    Uint64 getMax() const;
+    double getMean() const;
+
+    // Smallest recorded value that at least the given share of samples do not exceed,
+    // rounded up to its bucket; percentile is in [0, 100]
+    Uint64 getPercentile(double percentile) const;
+
+private:
+    enum {
+        SUB_BUCKET_BITS = 6,
+        SUB_BUCKETS = 1 << SUB_BUCKET_BITS,
+        HALF_SUB_BUCKETS = SUB_BUCKETS / 2,
+        MAX_BITS = 26, // Values are clamped to about 67 seconds
+        BUCKET_COUNT = (MAX_BITS - SUB_BUCKET_BITS + 1) * HALF_SUB_BUCKETS + HALF_SUB_BUCKETS
+    };
+
+    static int getBucketIndex(Uint64 value);
+    static Uint64 getBucketUpperBound(int index);
+
+    Uint32 mBuckets[BUCKET_COUNT];
+    Uint64 mCount;
+    Uint64 mMax;
+    Uint64 mSum;
+};
+
+#endif // FRAMETIMEHISTOGRAM_H
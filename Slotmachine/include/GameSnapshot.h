@@ -0,0 +1,24 @@
+#ifndef GAMESNAPSHOT_H
+#define GAMESNAPSHOT_H
+
+#include <SDL.h>
+
+// Simulated state of one reel after a step
+struct ReelState {
+    float position;         // Position after the last step
+    float previousPosition; // Position before the last step, wrapped together with position
+    bool spinning;
+};
+
+// Everything the render thread needs from the simulation, copied by value
+struct GameSnapshot {
+    enum { MAX_REELS = 8 };
+
+    ReelState reels[MAX_REELS];
+    int reelCount;
+    bool spinning;    // True while any reel is spinning
+    Uint32 spinCount; // Number of spins the simulation has started
+    Uint64 stepTime;  // Performance counter value of the last step
+};
+
+#endif // GAMESNAPSHOT_H
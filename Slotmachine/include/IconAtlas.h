@@ -0,0 +1,69 @@
+#ifndef ICONATLAS_H
+#define ICONATLAS_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include "Renderer.h"
+#include "AssetCache.h"
+#include "AssetLoader.h"
+
+class IconAtlas {
+public:
+    IconAtlas(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets);
+    ~IconAtlas();
+
+    // Decodes the icons and builds their mip chains on the CPU; icons that fail to load are skipped.
+    // Surfaces already decoded by the loader are used instead of reading the files again.
+    bool build(const std::vector<std::string>& iconPaths, AssetLoader* loader = nullptr);
+
+    // Packs the icons, resampled to fit a w x h cell, into one texture.
+    // Each cell size is built once and cached.
+    bool setCellSize(int width, int height);
+
+    // Texture and regions for the current cell size; nullptr and empty rects until setCellSize succeeds
+    SDL_Texture* getTexture() const;
+    int getIconCount() const;
+    const SDL_Rect& getIconRect(int index) const;
+
+    // Opaque white texels for drawing solid colored quads in the same batch
+    const SDL_Rect& getSolidRect() const;
+
+private:
+    enum {
+        PADDING = 2,     // Transparent gutter around each icon to avoid filtering bleed
+        SOLID_SIZE = 4   // Size of the solid white block
+    };
+
+    // Premultiplied ARGB8888 pixels, tightly packed
+    struct Image {
+        int width;
+        int height;
+        std::vector<Uint32> pixels;
+    };
+
+    // Atlas for one cell size
+    struct ScaledSet {
+        AssetCache::TextureHandle texture;
+        std::vector<SDL_Rect> iconRects;
+        SDL_Rect solidRect;
+    };
+
+    bool createScaledSet(int width, int height, ScaledSet& set);
+    static Image halveImage(const Image& source);
+    static Image resampleImage(const Image& source, int width, int height);
+
+    std::shared_ptr<Renderer> mRenderer;
+    std::shared_ptr<AssetCache> mAssets;
+    std::vector<std::vector<Image>> mMipChains; // Per icon: the source, then halved levels down to 1x1
+    std::map<std::pair<int, int>, ScaledSet> mScaledSets;
+    const ScaledSet* mCurrent;
+
+    // Prevent copying
+    IconAtlas(const IconAtlas&) = delete;
+    IconAtlas& operator=(const IconAtlas&) = delete;
+};
+
+#endif // ICONATLAS_H
@@ -5,20 +5,22 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>  // Include this for TTF_Font
 #include <string>
+#include <memory>
+#include "Renderer.h"
 
 class LTexture {
 public:
-    LTexture(SDL_Renderer* renderer);
+    LTexture(std::shared_ptr<Renderer> renderer);
     ~LTexture();
     bool loadFromFile(const std::string& path);
     bool loadFromRenderedText(const std::string& textureText, SDL_Color textColor, TTF_Font* font);
     void free();
     void render(int x, int y);
-    int getWidth();
-    int getHeight();
+    int getWidth() const;
+    int getHeight() const;
 
 private:
-    SDL_Renderer* mRenderer; // The actual SDL renderer
+    std::shared_ptr<Renderer> mRenderer; // Issues the draw calls so they are counted
     SDL_Texture* mTexture;
     int mWidth;
     int mHeight;
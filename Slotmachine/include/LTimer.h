@@ -2,21 +2,25 @@
 #define LTIMER_H
 
 #include <SDL.h>
+#include "FrameClock.h"
 
+// Stopwatch on a FrameClock; reads the time of the clock's last tick
 class LTimer {
 public:
-    LTimer();
+    LTimer(const FrameClock& clock);
     void start();
     void stop();
     void pause();
     void unpause();
-    Uint32 getTicks();
-    bool isStarted();
-    bool isPaused();
+    Uint32 getTicks() const;
+    double getMs() const;
+    bool isStarted() const;
+    bool isPaused() const;
 
 private:
-    Uint32 mStartTicks;
-    Uint32 mPausedTicks;
+    const FrameClock* mClock;
+    double mStartMs;
+    double mPausedMs;
     bool mPaused;
     bool mStarted;
 };
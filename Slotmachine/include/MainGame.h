@@ -11,6 +11,17 @@
 #include "FPSMeter.h"
 #include <SDL_mixer.h> 
 #include "Renderer.h" // Include the Renderer header file
+#include "TextRenderer.h"
+#include "AssetCache.h"
+#include "IconAtlas.h"
+#include "StaticLayer.h"
+#include "FrameScheduler.h"
+#include "FrameClock.h"
+#include "Simulation.h"
+#include "OutcomeEngine.h"
+#include "AssetLoader.h"
+#include "Subsystems.h"
+#include "Profiler.h"
 #include <memory>
 
 
@@ -26,20 +37,32 @@ public:
 
     bool init();
     bool loadMedia();
+    void drawSplash(int completed, int total);
     void handleEvents(bool& quit);
-    void render();
+    void handleEvent(const SDL_Event& e, bool& quit);
+    bool isIdle() const;
+    void waitForEvents(bool& quit);
+    void setFramePacing(int targetFrameRate, bool vsync);
+    void setRandomSeed(uint64_t seed);
+    bool render();
     void run();
     void close();
 	bool areReelsSpinning; 
 
 private:
-    SDL_Window* gWindow;
 	std::shared_ptr<Renderer> gRenderer;
+	std::shared_ptr<AssetCache> assets;
+	std::shared_ptr<AssetPack> assetPack; // Pre-decoded assets; must outlive the sounds created from it
+	std::shared_ptr<IconAtlas> iconAtlas;
+	std::shared_ptr<TextRenderer> textRenderer;
 	std::unique_ptr<Background> background;
 	std::unique_ptr<Frame> frame;
+	std::unique_ptr<StaticLayer> staticLayer; // Background and frame, rendered once
     std::unique_ptr<Button> button;
     std::vector<std::unique_ptr<Reel>> mReels;
 	std::unique_ptr<FPSMeter> fpsMeter;
+	AssetCache::FontHandle fpsFont;
+	AssetCache::FontHandle overlayFont; // Small text of the F3 details
     //Renderer* gRenderer;
     //Background* background;
     //Frame* frame;
@@ -48,13 +71,23 @@ private:
     //FPSMeter* fpsMeter; 
 
     // Time management
-    Uint32 lastTime;
-    Uint32 currentTime;
-    Uint32 deltaTime;
+    FrameClock frameClock; // Sampled once per frame; the one "now" for everything in the frame
+    FrameScheduler scheduler; // Paces frames only; the reels step in Simulation's own scheduler
+    bool vsyncEnabled;
+
+    std::unique_ptr<Simulation> simulation; // Reel physics on its own thread
+    Uint32 pendingSpin; // Last spin requested from the simulation
+    uint64_t randomSeed; // Seed of the simulation's and the outcomes' random streams
+
+    std::unique_ptr<OutcomeEngine> outcomeEngine; // Decides each spin before the reels move
+    Random outcomeRandom; // Stream the outcomes are drawn from, independent of the simulation's
+    SpinResult pendingResult; // Outcome the reels are spinning toward
     
 
  
     bool allReelsStopped() const;
+    bool bakeReelStrips();
+    AssetCache::TextureHandle reelStrips; // Pre-rendered strips of all reels, side by side
     Mix_Music* backgroundMusic;
 };
 
@@ -0,0 +1,34 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <SDL.h>
+#include <string>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    MappedFile();
+    ~MappedFile();
+
+    bool open(const std::string& path);
+    void close();
+
+    const Uint8* getData() const;
+    size_t getSize() const;
+
+private:
+    const Uint8* mData;
+    size_t mSize;
+#ifdef _WIN32
+    void* mFile;    // HANDLE
+    void* mMapping; // HANDLE
+#else
+    int mFile;
+#endif
+
+    // Prevent copying
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+#endif // MAPPEDFILE_H
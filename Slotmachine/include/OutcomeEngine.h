@@ -0,0 +1,99 @@
+#ifndef OUTCOMEENGINE_H
+#define OUTCOMEENGINE_H
+
+#include <cstdint>
+#include <vector>
+#include "Random.h"
+#include "PaylineEvaluator.h"
+
+// Reel strips, visible window, paylines and paytable of one machine.
+// Symbols are indices into the game's icon list.
+struct MachineConfig {
+    enum {
+        MAX_REELS = 8,
+        MAX_ROWS = 5,
+        MAX_PAYLINES = 32,
+        MAX_SYMBOLS = 16,
+        MAX_PAY = 0x7FFFFFFF / (2 * MAX_PAYLINES) // Every line paying it both ways still fits a signed 32-bit total
+    };
+
+    std::vector<std::vector<int>> strips;     // Symbols of each reel, top to bottom; strips wrap around
+    int rows;                                 // Symbols visible on each reel
+    std::vector<std::vector<int>> paylines;   // Row on each reel, for each line
+    std::vector<std::vector<uint32_t>> pays;  // pays[symbol][count]: win for count symbols in a row from the left, in line bets
+    int wild = -1;                            // Symbol that stands in for any other, or -1
+    bool bothWays = false;                    // Lines also pay runs from the right; a full line pays once
+
+    // Checks the limits above and that every line and pay refers to a valid reel, row or symbol
+    bool isValid() const;
+
+    // Five reels of three rows with five lines over three symbols: watermelon, apple, cherries
+    static MachineConfig createClassic();
+};
+
+// One paying line of a spin
+struct LineWin {
+    int line;
+    int symbol;
+    int count;
+    uint32_t pay;
+    bool rightToLeft;
+};
+
+// Outcome of one spin; fixed size so spins do not allocate
+struct SpinResult {
+    int reelCount;
+    int stops[MachineConfig::MAX_REELS];                          // Strip index shown in the top row
+    int window[MachineConfig::MAX_REELS][MachineConfig::MAX_ROWS]; // Visible symbols
+    int winCount;
+    LineWin wins[2 * MachineConfig::MAX_PAYLINES]; // Both directions on machines that pay both ways
+    uint32_t totalWin; // Sum of line wins, in line bets
+};
+
+// Picks and evaluates spin outcomes. Pure game math: no SDL, no rendering and
+// no allocation per spin, so it runs headless and from several threads at once
+// as long as each thread brings its own Random.
+class OutcomeEngine {
+public:
+    explicit OutcomeEngine(const MachineConfig& config);
+
+    const MachineConfig& getConfig() const;
+    int getReelCount() const;
+    int getLineCount() const;
+    int getStripLength(int reel) const;
+
+    // Draws uniform stops for every reel and evaluates them
+    void spin(Random& random, SpinResult& result) const;
+
+    // Fills in the window and line wins for the given stops
+    void evaluate(const int* stops, SpinResult& result) const;
+
+    // Total win for the given stops without the details
+    uint32_t evaluateWin(const int* stops) const;
+
+    // Total wins of count spins given as count * reel count stops, evaluated in
+    // SIMD batches; paying lines are added to counts unless it is nullptr
+    void evaluateWins(const int* stops, int count, uint32_t* wins, LineCounts* counts) const;
+
+    // Draws count spins and evaluates them like evaluateWins; the fast path for
+    // simulations. Draws the same stops as count calls to spin.
+    void spinWins(Random& random, int count, uint32_t* wins, LineCounts* counts) const;
+
+    // Selects the payline kernel; returns false if the CPU does not support it
+    bool setKernel(PaylineEvaluator::Kernel kernel);
+    PaylineEvaluator::Kernel getKernel() const;
+
+private:
+    // Copies the window shown by a set of stops into one lane of a batch
+    void fillWindow(const int* stops, int window, WindowBatch& batch) const;
+
+    MachineConfig mConfig;
+    int mReelCount;
+    int mRows;
+    int mLineCount;
+    int mStripLengths[MachineConfig::MAX_REELS];
+    std::vector<uint8_t> mStrips[MachineConfig::MAX_REELS]; // Each strip followed by its first rows - 1 symbols, so a window never wraps
+    PaylineEvaluator mEvaluator;
+};
+
+#endif // OUTCOMEENGINE_H
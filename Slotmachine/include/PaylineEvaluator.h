@@ -0,0 +1,119 @@
+#ifndef PAYLINEEVALUATOR_H
+#define PAYLINEEVALUATOR_H
+
+#include <cstdint>
+
+struct MachineConfig;
+
+// Visible windows of up to SIZE spins, one lane per window: cells[reel][row][window]
+// is the symbol shown in that cell, so a payline cell of consecutive windows is
+// one contiguous load.
+struct WindowBatch {
+    enum {
+        SIZE = 64,
+        MAX_REELS = 8,
+        MAX_ROWS = 5
+    };
+
+    int count; // Windows in use, from 0
+    uint8_t cells[MAX_REELS][MAX_ROWS][SIZE];
+};
+
+// Best win of each payline of one window in one direction; lines without a win have pay 0
+struct LineScores {
+    enum { MAX_LINES = 32 };
+
+    uint32_t pay[MAX_LINES];
+    int32_t symbol[MAX_LINES];
+    int32_t count[MAX_LINES];
+};
+
+// Paying lines by symbol and run length, both directions together
+struct LineCounts {
+    enum {
+        MAX_SYMBOLS = 16,
+        MAX_REELS = 8
+    };
+
+    uint64_t lines[MAX_SYMBOLS][MAX_REELS + 1];
+};
+
+// Evaluates the paylines of many windows at once, with one window per SIMD
+// lane. Each line pays the best run of one symbol from the left, and from the
+// right as well for machines that pay both ways; a wild extends the run of any
+// symbol. The kernel is chosen from the CPU at construction and can be overridden.
+class PaylineEvaluator {
+public:
+    enum Kernel {
+        KERNEL_SCALAR,
+        KERNEL_SSE41,
+        KERNEL_AVX2
+    };
+
+    // The configuration must be valid
+    explicit PaylineEvaluator(const MachineConfig& config);
+
+    // Fastest kernel this CPU and build support
+    static Kernel detectKernel();
+    static bool isKernelSupported(Kernel kernel);
+    static const char* getKernelName(Kernel kernel);
+
+    // Returns false and keeps the current kernel if the CPU lacks it
+    bool setKernel(Kernel kernel);
+    Kernel getKernel() const;
+
+    // Scores every line of one window of the batch; rightToLeft is only filled
+    // in for machines that pay both ways
+    void evaluate(const WindowBatch& batch, int window, LineScores& leftToRight, LineScores& rightToLeft) const;
+
+    // Writes the total win of each window in line bets and, if counts is not
+    // nullptr, adds every paying line to it
+    void evaluateBatch(const WindowBatch& batch, uint32_t* wins, LineCounts* counts) const;
+
+    bool paysBothWays() const;
+
+private:
+    enum {
+        MAX_REELS = WindowBatch::MAX_REELS,
+        MAX_SYMBOLS = LineCounts::MAX_SYMBOLS
+    };
+
+    // A symbol and run length with a non-zero pay
+    struct PayingRun {
+        int symbol;
+        int count;
+    };
+
+    // Evaluates windows [begin, end); the SIMD kernels need a whole number of vectors
+    typedef void (PaylineEvaluator::*KernelFunction)(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const;
+
+    // Best win of one line of one window
+    uint32_t scoreLine(const WindowBatch& batch, int window, int line, bool rightToLeft, int& symbol, int& count) const;
+
+    void evaluateScalar(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const;
+    void evaluateSse41(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const;
+    void evaluateAvx2(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const;
+
+    // One direction of the SIMD kernels, added to wins; specialized for machines
+    // with a wild and for counting lines
+    template <bool Wild, bool Count>
+    void scoreSse41(const WindowBatch& batch, int begin, int end, int direction, uint32_t* wins, LineCounts* counts) const;
+    template <bool Wild, bool Count>
+    void scoreAvx2(const WindowBatch& batch, int begin, int end, int direction, uint32_t* wins, LineCounts* counts) const;
+
+    int mReelCount;
+    int mLineCount;
+    int mWild;      // Wild symbol, or -1
+    bool mBothWays;
+    uint16_t mCellOffsets[2][LineScores::MAX_LINES][MAX_REELS]; // By direction; offset of each line's cells in a batch, in run order
+    int mPayingSymbolCount[2];
+    int mPayingSymbols[2][MAX_SYMBOLS]; // By direction; symbols with any pay, the only ones worth evaluating
+    int mPayingRunStarts[2][MAX_SYMBOLS + 1]; // By direction; first paying run of each paying symbol
+    PayingRun mPayingRuns[2][MAX_SYMBOLS * MAX_REELS]; // By direction, grouped by paying symbol; the lines worth counting
+    uint32_t mPays[2][MAX_SYMBOLS][MAX_REELS + 1]; // By direction; a full line pays only from the left
+    Kernel mKernel;
+    KernelFunction mKernelFunction;
+    int mKernelLanes; // Windows per vector of the kernel
+};
+
+#endif // PAYLINEEVALUATOR_H
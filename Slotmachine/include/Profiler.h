@@ -0,0 +1,96 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <SDL.h>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+
+// Frame profiler. Scoped zones are appended to a lock-free ring buffer owned
+// by the recording thread and can be exported as Chrome trace JSON
+// (chrome://tracing or ui.perfetto.dev). Recording is off until enabled; a
+// disabled zone costs one relaxed atomic load.
+class Profiler {
+public:
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    // Names the calling thread in exported traces; the name must outlive the profiler
+    static void setThreadName(const char* name);
+
+    // Appends a finished zone to the calling thread's ring; name must be a string literal
+    static void recordZone(const char* name, Uint64 start, Uint64 end);
+
+    // Writes every zone still held in the rings; returns false if the file cannot be written
+    static bool writeChromeTrace(const std::string& path);
+
+    // Total number of zones recorded since startup
+    static Uint64 getZoneCount();
+
+private:
+    enum { RING_CAPACITY = 1 << 15 }; // Zones kept per thread; older ones are overwritten
+
+    struct Zone {
+        const char* name;
+        Uint64 start;
+        Uint64 end;
+    };
+
+    // One ring entry. The sequence is odd while the owner writes zone n into
+    // it and 2n + 2 once written, so the exporter can tell a torn copy.
+    struct ZoneSlot {
+        std::atomic<Uint64> sequence;
+        std::atomic<const char*> name;
+        std::atomic<Uint64> start;
+        std::atomic<Uint64> end;
+    };
+
+    // Written only by its thread; the slots are allocated under sRingsMutex
+    // when the thread records its first zone
+    struct ThreadRing {
+        std::unique_ptr<ZoneSlot[]> slots;
+        std::atomic<Uint64> head;
+        int threadId;
+        const char* threadName;
+    };
+
+    static ThreadRing* getThreadRing();
+    static void allocateSlots(ThreadRing* ring);
+
+    static std::atomic<bool> sEnabled;
+    // Guards sRings, thread names and slot allocation; taken on a thread's
+    // first use and first zone, and on export
+    static std::mutex sRingsMutex;
+    static std::vector<std::unique_ptr<ThreadRing>> sRings;
+
+    Profiler() = delete;
+};
+
+// Records the enclosing scope as a zone while the profiler is enabled
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name)
+        : mName(name), mStart(Profiler::isEnabled() ? SDL_GetPerformanceCounter() : 0) {}
+
+    ~ProfileZone() {
+        if (mStart != 0) {
+            Profiler::recordZone(mName, mStart, SDL_GetPerformanceCounter());
+        }
+    }
+
+private:
+    const char* mName;
+    Uint64 mStart;
+
+    // Prevent copying
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+
+#endif // PROFILER_H
@@ -0,0 +1,78 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+#include <cstddef>
+
+// xoshiro256** pseudo-random generator with per-instance state. Not thread-safe;
+// give each thread its own stream with split(), which jumps 2^128 values ahead.
+// Does not depend on SDL so tools can use it on their own.
+class Random {
+public:
+    // The seed is expanded with splitmix64, so any value, including 0, is fine
+    explicit Random(uint64_t seed);
+    void seed(uint64_t seed);
+
+    // Seed from the system entropy source and the clock
+    static uint64_t makeSeed();
+
+    // 64 uniformly random bits
+    uint64_t next();
+
+    // Uniform in [0, bound) without modulo bias; bound must be non-zero
+    uint32_t nextBounded(uint32_t bound);
+
+    // Uniform in [min, max], both inclusive
+    int nextInt(int min, int max);
+
+    // Uniform in [0, 1) with 53 random bits, and in [min, max) as a float
+    double nextDouble();
+    float nextFloat(float min, float max);
+
+    // Bulk generation, faster than calling next() from a loop outside
+    void fill(uint64_t* values, size_t count);
+    void fillBounded(uint32_t* values, size_t count, uint32_t bound);
+    void fillBytes(void* bytes, size_t size);
+
+    // Advance the state by 2^128 and 2^192 values respectively
+    void jump();
+    void longJump();
+
+    // Returns a generator for the current stream and moves this one to the next
+    // stream, so repeated calls hand out non-overlapping sequences of 2^128 values
+    Random split();
+
+private:
+    void jump(const uint64_t (&polynomial)[4]);
+
+    uint64_t mState[4];
+};
+
+inline uint64_t Random::next() {
+    const uint64_t result = ((mState[1] * 5) << 7 | (mState[1] * 5) >> 57) * 9;
+    const uint64_t t = mState[1] << 17;
+    mState[2] ^= mState[0];
+    mState[3] ^= mState[1];
+    mState[1] ^= mState[2];
+    mState[0] ^= mState[3];
+    mState[2] ^= t;
+    mState[3] = (mState[3] << 45) | (mState[3] >> 19);
+    return result;
+}
+
+// Lemire's multiply-shift method: the rejection only happens for the few low
+// products that would otherwise make some results more likely
+inline uint32_t Random::nextBounded(uint32_t bound) {
+    uint64_t product = (next() >> 32) * bound;
+    uint32_t low = static_cast<uint32_t>(product);
+    if (low < bound) {
+        const uint32_t threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = (next() >> 32) * bound;
+            low = static_cast<uint32_t>(product);
+        }
+    }
+    return static_cast<uint32_t>(product >> 32);
+}
+
+#endif // RANDOM_H
@@ -5,45 +5,54 @@
 #include <vector>
 #include <string>
 #include "Renderer.h"
+#include "IconAtlas.h"
+#include "GameSnapshot.h"
 #include <memory>
 
 class Reel {
 public:
-    Reel(std::shared_ptr<Renderer> renderer, int x, int y, int w, int h, const std::vector<std::string>& iconPaths);
+    Reel(std::shared_ptr<Renderer> renderer, std::shared_ptr<IconAtlas> atlas, int x, int y, int w, int h);
     ~Reel();
 
-    void loadIcons(const std::vector<std::string>& iconPaths);
     void setClipRect(const SDL_Rect& clipRect);
-    void render(Uint32 deltaTime);
-    void renderIcon(int index, int yOffset, int iconHeight);
-    void update(Uint32 deltaTime);
-    void setPosition(int position);
-    void startSpin(int startOffset, Uint32 stopDelay);
-    void stopSpin();
-    bool isSpinning() const;
-    void setRandomSpinSpeed();
-    void setStopTime(Uint32 time);
-    bool shouldStop(Uint32 currentTime);
-    void stopSpinAfterDelay(Uint32 delay);
+
+    // Symbols on the strip, top to bottom, and how many are visible at once; call before bakeStrip
+    void setStrip(const std::vector<int>& symbols, int rows);
+    void bakeStrip(SDL_Texture* stripTexture, int stripX);
+    void render(const SDL_Rect& region);
+    void setState(const ReelState& state, float alpha);
+    const SDL_Rect& getRect() const;
+
+    // Area one icon is fitted into; the icon atlas is resampled to this size
+    SDL_Point getIconCellSize() const;
+
+    // Height of the whole strip in pixels; a position of stop * cell height shows that stop in the top row
+    int getStripHeight() const;
 
 private:
-    void setRandomPosition();
+    enum {
+        BORDER_OFFSET = 22 // Margin between the reel edge and its icons
+    };
+
+    // Placement of one icon in the strip, relative to the strip column
+    struct IconCell {
+        int icon;
+        SDL_Rect rect;
+    };
+
+    void updateLayout();
 
     std::shared_ptr<Renderer> mRenderer;
+    std::shared_ptr<IconAtlas> mAtlas; // Icon texture shared with the other reels
     SDL_Rect mReelRect;
     SDL_Rect mClipRect;
-    std::vector<SDL_Texture*> mIcons;
-    int mCurrentIconIndex;
-    bool mSpinning;
-    Uint32 mSpinStartTime;
-    Uint32 mSpinDuration;
-    int mStartPosition;
-    int mMaxPosition;
-    int mOriginalIconHeight;
-    int mStartPositionOffset; // Offset for staggered start
-    int mStopDelay; // Delay before stopping
-    Uint32 mStopTime; // Time when the reel should stop
-    float mSpinSpeed;
+    int mStartPosition; // Interpolated position used for rendering
+    std::vector<int> mStrip; // Symbol at each stop
+    int mRows; // Stops visible at once
+    SDL_Texture* mStripTexture; // Pre-rendered strip, owned by the caller of bakeStrip
+    int mStripX; // Column of this reel in mStripTexture
+    std::vector<IconCell> mIconCells; // Cached layout for the atlas cell size below
+    SDL_Texture* mLayoutTexture; // Atlas texture mIconCells was computed for
 
     // Prevent copying
     Reel(const Reel&) = delete;
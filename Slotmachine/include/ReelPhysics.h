@@ -0,0 +1,41 @@
+#ifndef REELPHYSICS_H
+#define REELPHYSICS_H
+
+#include "GameSnapshot.h"
+#include "Random.h"
+
+// Spin motion of a single reel, advanced in fixed steps by the simulation thread.
+// The stop is decided before the spin starts; the motion is planned so the reel
+// cruises, brakes and comes to rest exactly on it.
+class ReelPhysics {
+public:
+    ReelPhysics(int height, int iconCount, const Random& random);
+
+    void startSpin(float stopDelay, int targetStop);
+    void update(float stepMs);
+    void setPosition(int position);
+    bool isSpinning() const;
+    const ReelState& getState() const;
+
+private:
+    enum {
+        BRAKE_MS = 400 // Time the reel takes to slow down to rest
+    };
+
+    void setRandomSpinSpeed();
+    float getDistanceTravelled() const;
+
+    ReelState mState;
+    int mHeight;         // Strip height in pixels
+    int mIconCount;      // Stops on the strip
+    float mSpinElapsed;  // Simulated time since the spin started, in milliseconds
+    float mSpinDuration;
+    float mStopDelay;    // Extra spin time before stopping
+    float mSpinSpeed;    // Cruise speed in pixels per millisecond
+    float mSpinStart;    // Position when the spin started
+    float mSpinDistance; // Distance from mSpinStart to the target stop, including whole turns
+    int mTargetStop;
+    Random mRandom;      // This reel's own stream
+};
+
+#endif // REELPHYSICS_H
@@ -5,6 +5,28 @@
 #include <SDL_ttf.h>
 #include <SDL_image.h>
 #include <string>
+#include <vector>
+
+// Calls issued to the SDL renderer during one frame, by type
+struct RenderStats {
+    int clears;
+    int copies;             // SDL_RenderCopy, including the canvas copy
+    int geometryBatches;    // SDL_RenderGeometry
+    int batchedQuads;       // Quads submitted in those batches
+    int fillRects;
+    int lines;
+    int drawColorChanges;
+    int clipRectChanges;
+    int targetChanges;
+    int textureSwitches;    // Draws with a different texture than the previous draw
+    int textureModChanges;  // Color and alpha mods
+    int textureUploads;     // SDL_UpdateTexture into streaming textures
+    int presents;
+    int skippedStateChanges; // Calls not issued because the state was already set
+
+    int getDrawCalls() const;
+    int getStateChanges() const;
+};
 
 class Renderer {
 public:
@@ -15,6 +37,9 @@ public:
     // Initializes SDL, creates window and renderer
     bool init(const std::string& windowTitle);
 
+    // Synchronizes presents to the display refresh; returns false if unsupported
+    bool setVSync(bool enabled);
+
     // Clears the screen with a specified color
     void clearScreen(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
@@ -24,6 +49,22 @@ public:
     // Loads a texture from a file
     SDL_Texture* loadTexture(const std::string& filePath);
 
+    // Uploads a decoded surface; the surface is not freed
+    SDL_Texture* createTexture(SDL_Surface* surface);
+
+    // Creates an immutable texture and uploads raw pixels into it
+    SDL_Texture* createStaticTexture(Uint32 format, int width, int height, const void* pixels, int pitch);
+
+    // Blends a texture whose colors are already multiplied by alpha; falls back to
+    // straight alpha blending and returns false if the backend lacks custom blend modes
+    static bool setPremultipliedBlendMode(SDL_Texture* texture);
+
+    // Tints the texture for later draws; alpha scales its opacity
+    void setTextureColorMod(SDL_Texture* texture, SDL_Color color);
+
+    // Sets how the texture is blended when drawn
+    void setTextureBlendMode(SDL_Texture* texture, SDL_BlendMode blendMode);
+
     // Renders a texture to the screen
     void renderTexture(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* destRect);
 
@@ -35,8 +76,52 @@ public:
 
 	void drawLine(int x1, int y1, int x2, int y2); // Declare the drawLine method
 
-    // Accessor for SDL_Renderer
-    SDL_Renderer* getSDLRenderer() const;
+    // Creates a texture that can be used as a render target
+    SDL_Texture* createTargetTexture(int width, int height);
+
+    // Creates an ARGB8888 texture whose pixels are replaced often, and replaces them
+    SDL_Texture* createStreamingTexture(int width, int height);
+    bool updateTexture(SDL_Texture* texture, const SDL_Rect* rect, const void* pixels, int pitch);
+
+    // Redirects rendering to a texture, or back to the window with nullptr
+    void setRenderTarget(SDL_Texture* texture);
+
+    // Starts collecting textured quads that share one texture
+    void beginBatch(SDL_Texture* texture);
+
+    // Adds a quad to the current batch, optionally clipped on the CPU
+    void batchQuad(const SDL_Rect& srcRect, const SDL_Rect& destRect, SDL_Color color);
+    void batchQuad(const SDL_Rect& srcRect, const SDL_Rect& destRect, const SDL_Rect& clipRect, SDL_Color color);
+
+    // Submits the current batch with a single SDL_RenderGeometry call
+    void flushBatch();
+
+    // Restricts drawing to a rectangle, or removes the restriction with nullptr
+    void setClipRect(const SDL_Rect* rect);
+
+    // Marks a screen region as changed so the next frame repaints it
+    void invalidate(const SDL_Rect& rect);
+    void invalidateAll();
+
+    // True if any region is waiting to be repainted
+    bool hasDirtyRegions() const;
+
+    // Starts a partial repaint into the retained canvas; returns false if nothing changed
+    bool beginFrame();
+
+    // Regions to repaint in the current frame, merged and clipped to the screen
+    const std::vector<SDL_Rect>& getDirtyRegions() const;
+
+    // Copies the canvas to the window, presents it and clears the dirty regions
+    void endFrame();
+
+    // Percentage of screen pixels repainted in the last frame, and averaged since the last reset
+    float getRepaintPercent() const;
+    float getAverageRepaintPercent() const;
+    void resetRepaintStats();
+
+    // Calls issued by the last frame that was presented
+    const RenderStats& getFrameStats() const;
 
     // Cleans up SDL resources
     void cleanup();
@@ -46,6 +131,40 @@ private:
     int mScreenHeight;
     SDL_Window* mWindow;
     SDL_Renderer* mRenderer;
+
+    // Geometry batch; the vectors keep their capacity between frames
+    SDL_Texture* mBatchTexture;
+    float mBatchTextureWidth;
+    float mBatchTextureHeight;
+    std::vector<SDL_Vertex> mBatchVertices;
+    std::vector<int> mBatchIndices;
+
+    // Dirty-region tracking; the canvas keeps the last frame because the
+    // back buffer is undefined after a present
+    static const size_t MAX_DIRTY_REGIONS = 8;
+    SDL_Texture* mCanvas;
+    bool mInFrame;
+    std::vector<SDL_Rect> mDirtyRegions;
+    std::vector<SDL_Rect> mPendingRegions;
+    float mRepaintPercent;
+    double mRepaintPercentSum;
+    int mRepaintFrames;
+
+    // Counted as the calls are issued; the current counts move to mFrameStats on endFrame
+    void countTexture(SDL_Texture* texture);
+    RenderStats mCurrentStats;
+    RenderStats mFrameStats;
+    SDL_Texture* mLastDrawTexture;
+
+    // Last state set on the SDL renderer, so unchanged values are not set again.
+    // SDL resets the clip rect when the render target changes.
+    SDL_Color mDrawColor;
+    bool mDrawColorKnown;
+    SDL_Rect mClipRect;
+    bool mClipEnabled;
+    bool mClipKnown;
+    SDL_Texture* mRenderTarget;
+    bool mRenderTargetKnown;
 };
 
 #endif // RENDERER_H
@@ -0,0 +1,68 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <SDL.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "GameSnapshot.h"
+#include "TripleBuffer.h"
+#include "ReelPhysics.h"
+#include "FrameScheduler.h"
+#include "Random.h"
+
+// Runs the reel physics on its own thread in fixed steps and publishes the
+// result as a GameSnapshot, so rendering and presenting never delay it.
+class Simulation {
+public:
+    // Equal seeds replay the same spins
+    Simulation(double stepMs, uint64_t seed);
+    ~Simulation();
+
+    // Adds a reel with a strip of stopCount stops; only valid before start()
+    bool addReel(int stripHeight, int stopCount);
+
+    bool start();
+    void stop();
+
+    // Thread-safe; the reels stop on the given stops, one per reel. Returns the
+    // spin number the snapshot's spinCount reaches once it starts
+    Uint32 requestSpin(const int* stops, int count);
+
+    // Render thread: the latest published snapshot
+    const GameSnapshot& acquireSnapshot();
+
+    // Fraction of a step elapsed since the snapshot was taken, for rendering
+    float getInterpolation(const GameSnapshot& snapshot, Uint64 now) const;
+
+private:
+    void threadMain();
+    bool isIdle() const;
+    void startSpin();
+    void publish();
+
+    std::vector<ReelPhysics> mReels; // Owned by the simulation thread once started
+    Random mRandom; // Split into one stream per reel
+    TripleBuffer<GameSnapshot> mSnapshots;
+    FrameScheduler mScheduler;
+    double mStepMs;
+    Uint64 mStepTicks;
+
+    std::thread mThread;
+    std::atomic<bool> mRunning;
+    std::atomic<Uint32> mRequestedSpins;
+    Uint32 mStartedSpins;
+
+    // Wakes the thread while no reel is spinning and guards the requested stops
+    std::mutex mWakeMutex;
+    int mRequestedStops[GameSnapshot::MAX_REELS];
+    std::condition_variable mWake;
+
+    // Prevent copying
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+};
+
+#endif // SIMULATION_H
@@ -0,0 +1,40 @@
+#ifndef STATICLAYER_H
+#define STATICLAYER_H
+
+#include <SDL.h>
+#include <functional>
+#include <memory>
+#include "Renderer.h"
+#include "AssetCache.h"
+
+class StaticLayer {
+public:
+    StaticLayer(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets, int width, int height);
+    ~StaticLayer();
+
+    // Marks the cached image stale, e.g. after a resize or an asset change
+    void invalidate();
+    bool isDirty() const;
+
+    // Re-renders the layer into its target texture if it is dirty
+    bool composite(const std::function<void()>& drawLayer);
+
+    // Copies the cached image, or one region of it, to the current render target
+    void render();
+    void render(const SDL_Rect& region);
+
+private:
+    std::shared_ptr<Renderer> mRenderer;
+    std::shared_ptr<AssetCache> mAssets;
+    AssetCache::TextureHandle mTexture;
+    int mWidth;
+    int mHeight;
+    bool mDirty;
+    bool mAvailable; // False once the target texture could not be created
+
+    // Prevent copying
+    StaticLayer(const StaticLayer&) = delete;
+    StaticLayer& operator=(const StaticLayer&) = delete;
+};
+
+#endif // STATICLAYER_H
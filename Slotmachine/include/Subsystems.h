@@ -0,0 +1,42 @@
+#ifndef SUBSYSTEMS_H
+#define SUBSYSTEMS_H
+
+#include <SDL.h>
+#include <vector>
+
+// Single owner of the process-wide SDL, SDL_image, SDL_ttf and SDL_mixer state.
+// Each library is started on first use and shut down once, in reverse order.
+// Call only from the main thread.
+class Subsystems {
+public:
+    // Start a library if it is not running yet; return false if it failed
+    static bool ensureVideo();
+    static bool ensureImage();
+    static bool ensureFonts();
+    static bool ensureAudio();
+
+    // Records a startup phase that began at the given performance counter value.
+    // Phases may nest; the report total is the wall time from the first start to the last end.
+    static void addPhase(const char* name, Uint64 startCounter);
+    static void printStartupReport();
+
+    // Shuts down every library that was started
+    static void shutdown();
+
+private:
+    struct Phase {
+        const char* name;
+        Uint64 start;
+        Uint64 end;
+    };
+
+    static bool sVideo;
+    static bool sImage;
+    static bool sFonts;
+    static bool sAudio;
+    static std::vector<Phase> sPhases;
+
+    Subsystems() = delete;
+};
+
+#endif // SUBSYSTEMS_H
@@ -0,0 +1,83 @@
+#ifndef TEXTRENDERER_H
+#define TEXTRENDERER_H
+
+#include <SDL.h>
+#include <SDL_ttf.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include "Renderer.h"
+#include "AssetCache.h"
+
+class TextRenderer {
+public:
+    typedef int FontId;  // Handle to a font + glyph atlas, -1 if invalid
+    typedef int TextId;  // Handle to a laid-out string, -1 if invalid
+
+    TextRenderer(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets);
+    ~TextRenderer();
+
+    // Opens a font once per (path, size) and builds its glyph atlas
+    FontId loadFont(const std::string& path, int size);
+
+    // Lays out a string once and caches the glyph quads
+    TextId prepareText(FontId font, const std::string& text);
+
+    // Draws a prepared string; no allocations or file I/O
+    void drawText(TextId text, int x, int y, SDL_Color color);
+
+    // Size of a prepared string in pixels
+    int getTextWidth(TextId text) const;
+    int getTextHeight(TextId text) const;
+
+    // Releases all fonts, atlases and cached layouts
+    void clear();
+
+private:
+    enum {
+        FIRST_GLYPH = 32,   // ' '
+        LAST_GLYPH = 126,   // '~'
+        GLYPH_COUNT = LAST_GLYPH - FIRST_GLYPH + 1,
+        ATLAS_WIDTH = 512
+    };
+
+    struct Glyph {
+        SDL_Rect src;  // Region of the glyph in the atlas texture
+        int advance;   // Horizontal pen advance
+    };
+
+    struct FontAtlas {
+        AssetCache::FontHandle font;
+        AssetCache::TextureHandle texture;
+        int height;
+        Glyph glyphs[GLYPH_COUNT];
+    };
+
+    struct Quad {
+        SDL_Rect src;
+        SDL_Rect dst;  // Relative to the text origin
+    };
+
+    struct TextLayout {
+        FontId font;
+        std::vector<Quad> quads;
+        int width;
+        int height;
+    };
+
+    bool buildAtlas(FontAtlas& atlas, const std::string& key);
+
+    std::shared_ptr<Renderer> mRenderer;
+    std::shared_ptr<AssetCache> mAssets;
+    std::vector<FontAtlas> mFonts;
+    std::map<std::pair<std::string, int>, FontId> mFontIndex;
+    std::vector<TextLayout> mLayouts;
+    std::map<std::pair<FontId, std::string>, TextId> mLayoutIndex;
+
+    // Prevent copying
+    TextRenderer(const TextRenderer&) = delete;
+    TextRenderer& operator=(const TextRenderer&) = delete;
+};
+
+#endif // TEXTRENDERER_H
@@ -0,0 +1,48 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+
+// Lock-free single-producer, single-consumer triple buffer. The writer fills
+// back() and publishes it; the reader always gets the most recently published
+// value. Neither side ever waits for the other.
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() : mBuffers(), mBack(0), mMiddle(1), mFront(2) {}
+
+    // Writer: the slot to fill before publish(); may hold any older value
+    T& back() {
+        return mBuffers[mBack];
+    }
+
+    // Writer: makes back() visible to the reader and takes a free slot in return
+    void publish() {
+        mBack = mMiddle.exchange(mBack | FRESH, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader: swaps in the latest published value if there is one
+    const T& acquire() {
+        if (mMiddle.load(std::memory_order_relaxed) & FRESH) {
+            mFront = mMiddle.exchange(mFront, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return mBuffers[mFront];
+    }
+
+private:
+    enum {
+        INDEX_MASK = 0x3,
+        FRESH = 0x4 // Set while the middle slot holds a value the reader has not taken
+    };
+
+    T mBuffers[3];
+    int mBack;               // Owned by the writer
+    std::atomic<int> mMiddle; // Exchanged between the two sides
+    int mFront;              // Owned by the reader
+
+    // Prevent copying
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+};
+
+#endif // TRIPLEBUFFER_H
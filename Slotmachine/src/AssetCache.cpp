@@ -0,0 +1,225 @@
+#include "AssetCache.h"
+#include "Subsystems.h"
+#include <stdio.h>
+#include <iterator>
+
+/**
+ * Constructor for the AssetCache class.
+ * @param renderer The custom Renderer used to upload textures.
+ */
+AssetCache::AssetCache(std::shared_ptr<Renderer> renderer)
+    : mRenderer(renderer) {}
+
+/**
+ * Destructor for the AssetCache class.
+ * Outstanding handles keep their assets alive; the cache only forgets them.
+ */
+AssetCache::~AssetCache() {}
+
+/**
+ * Gets a texture for the given file, loading it on first use.
+ * @param path The file path to the image.
+ * @return A shared texture handle, or nullptr if loading failed.
+ */
+AssetCache::TextureHandle AssetCache::getTexture(const std::string& path) {
+    auto it = mTextures.find(path);
+    if (it != mTextures.end()) {
+        if (TextureHandle handle = it->second.handle.lock()) {
+            return handle;
+        }
+    }
+
+    SDL_Texture* texture = mRenderer->loadTexture(path);
+    if (texture == nullptr) {
+        printf("Unable to load texture %s!\n", path.c_str());
+        return nullptr;
+    }
+    return adoptTexture(path, texture);
+}
+
+/**
+ * Registers a texture under the given key and takes ownership of it.
+ * @param key The cache key, e.g. a file path or a generated name.
+ * @param texture The texture to adopt.
+ * @return A shared texture handle, or nullptr if the texture is null.
+ */
+AssetCache::TextureHandle AssetCache::adoptTexture(const std::string& key, SDL_Texture* texture) {
+    if (texture == nullptr) {
+        return nullptr;
+    }
+    TextureHandle handle(texture, SDL_DestroyTexture);
+    Entry<SDL_Texture>& entry = mTextures[key];
+    entry.handle = handle;
+    entry.bytes = textureBytes(texture);
+    return handle;
+}
+
+/**
+ * Gets a font for the given file and point size, opening it on first use.
+ * @param path The file path to the font.
+ * @param size The point size of the font.
+ * @return A shared font handle, or nullptr if loading failed.
+ */
+AssetCache::FontHandle AssetCache::getFont(const std::string& path, int size) {
+    std::string key = path + "@" + std::to_string(size);
+    auto it = mFonts.find(key);
+    if (it != mFonts.end()) {
+        if (FontHandle handle = it->second.handle.lock()) {
+            return handle;
+        }
+    }
+
+    if (!Subsystems::ensureFonts()) {
+        return nullptr;
+    }
+    TTF_Font* font = TTF_OpenFont(path.c_str(), size);
+    if (font == nullptr) {
+        printf("Failed to load font %s! SDL_ttf Error: %s\n", path.c_str(), TTF_GetError());
+        return nullptr;
+    }
+
+    FontHandle handle(font, TTF_CloseFont);
+    Entry<TTF_Font>& entry = mFonts[key];
+    entry.handle = handle;
+    entry.bytes = fileBytes(path); // SDL_ttf keeps the face data in memory
+    return handle;
+}
+
+/**
+ * Gets a decoded sound chunk for the given file, loading it on first use.
+ * @param path The file path to the sound.
+ * @return A shared sound handle, or nullptr if loading failed.
+ */
+AssetCache::SoundHandle AssetCache::getSound(const std::string& path) {
+    auto it = mSounds.find(path);
+    if (it != mSounds.end()) {
+        if (SoundHandle handle = it->second.handle.lock()) {
+            return handle;
+        }
+    }
+
+    if (!Subsystems::ensureAudio()) {
+        return nullptr;
+    }
+    Mix_Chunk* chunk = Mix_LoadWAV(path.c_str());
+    if (chunk == nullptr) {
+        printf("Failed to load sound %s! SDL_mixer Error: %s\n", path.c_str(), Mix_GetError());
+        return nullptr;
+    }
+    return adoptSound(path, chunk);
+}
+
+/**
+ * Registers a decoded sound chunk under the given key and takes ownership of it.
+ * @param key The cache key, usually the file path.
+ * @param chunk The sound chunk to adopt.
+ * @return A shared sound handle, or nullptr if the chunk is null.
+ */
+AssetCache::SoundHandle AssetCache::adoptSound(const std::string& key, Mix_Chunk* chunk) {
+    if (chunk == nullptr) {
+        return nullptr;
+    }
+    SoundHandle handle(chunk, Mix_FreeChunk);
+    Entry<Mix_Chunk>& entry = mSounds[key];
+    entry.handle = handle;
+    entry.bytes = chunk->alen;
+    return handle;
+}
+
+/**
+ * Lists every asset that is still referenced together with its resident size.
+ * @return One entry per live asset.
+ */
+std::vector<AssetCache::AssetInfo> AssetCache::getResidentAssets() const {
+    std::vector<AssetInfo> assets;
+    for (const auto& item : mTextures) {
+        long refs = item.second.handle.use_count();
+        if (refs > 0) {
+            assets.push_back({ item.first, "texture", item.second.bytes, refs });
+        }
+    }
+    for (const auto& item : mFonts) {
+        long refs = item.second.handle.use_count();
+        if (refs > 0) {
+            assets.push_back({ item.first, "font", item.second.bytes, refs });
+        }
+    }
+    for (const auto& item : mSounds) {
+        long refs = item.second.handle.use_count();
+        if (refs > 0) {
+            assets.push_back({ item.first, "sound", item.second.bytes, refs });
+        }
+    }
+    return assets;
+}
+
+/**
+ * Gets the total resident size of all live assets.
+ * @return The size in bytes.
+ */
+size_t AssetCache::getResidentBytes() const {
+    size_t total = 0;
+    for (const AssetInfo& info : getResidentAssets()) {
+        total += info.bytes;
+    }
+    return total;
+}
+
+/**
+ * Prints the resident size and reference count of every live asset.
+ */
+void AssetCache::printReport() const {
+    std::vector<AssetInfo> assets = getResidentAssets();
+    size_t total = 0;
+    printf("Resident assets:\n");
+    for (const AssetInfo& info : assets) {
+        printf("  %-8s %10zu bytes  refs=%ld  %s\n", info.type.c_str(), info.bytes, info.refs, info.key.c_str());
+        total += info.bytes;
+    }
+    printf("  total    %10zu bytes in %zu assets\n", total, assets.size());
+}
+
+/**
+ * Drops cache entries whose assets have already been freed.
+ */
+void AssetCache::purge() {
+    for (auto it = mTextures.begin(); it != mTextures.end();) {
+        it = it->second.handle.expired() ? mTextures.erase(it) : std::next(it);
+    }
+    for (auto it = mFonts.begin(); it != mFonts.end();) {
+        it = it->second.handle.expired() ? mFonts.erase(it) : std::next(it);
+    }
+    for (auto it = mSounds.begin(); it != mSounds.end();) {
+        it = it->second.handle.expired() ? mSounds.erase(it) : std::next(it);
+    }
+}
+
+/**
+ * Estimates the GPU memory used by a texture.
+ * @param texture The texture to measure.
+ * @return The size in bytes.
+ */
+size_t AssetCache::textureBytes(SDL_Texture* texture) {
+    Uint32 format = 0;
+    int w = 0;
+    int h = 0;
+    if (SDL_QueryTexture(texture, &format, nullptr, &w, &h) != 0) {
+        return 0;
+    }
+    return static_cast<size_t>(w) * h * SDL_BYTESPERPIXEL(format);
+}
+
+/**
+ * Gets the size of a file on disk.
+ * @param path The file path.
+ * @return The size in bytes, or 0 if the file cannot be opened.
+ */
+size_t AssetCache::fileBytes(const std::string& path) {
+    SDL_RWops* file = SDL_RWFromFile(path.c_str(), "rb");
+    if (file == nullptr) {
+        return 0;
+    }
+    Sint64 size = SDL_RWsize(file);
+    SDL_RWclose(file);
+    return size > 0 ? static_cast<size_t>(size) : 0;
+}
@@ -0,0 +1,275 @@
+#include "AssetLoader.h"
+#include "Subsystems.h"
+#include "Profiler.h"
+#include <SDL_image.h>
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <system_error>
+
+/**
+ * Constructor for the AssetLoader class.
+ * @param renderer The custom Renderer used to upload textures.
+ * @param assets The AssetCache that receives the loaded assets.
+ */
+AssetLoader::AssetLoader(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets)
+    : mRenderer(renderer), mAssets(assets), mNextJob(0) {}
+
+/**
+ * Destructor for the AssetLoader class.
+ * Frees surfaces that were never taken and releases the loader's handles.
+ */
+AssetLoader::~AssetLoader() {
+    for (auto& item : mSurfaces) {
+        SDL_FreeSurface(item.second.surface);
+    }
+}
+
+/**
+ * Queues an image to be decoded and uploaded to a texture.
+ * @param path The file path to the image.
+ */
+void AssetLoader::addTexture(const std::string& path) {
+    mJobs.push_back({ JOB_TEXTURE, path, nullptr, nullptr });
+}
+
+/**
+ * Queues an image to be decoded and kept as a surface.
+ * @param path The file path to the image.
+ */
+void AssetLoader::addSurface(const std::string& path) {
+    mJobs.push_back({ JOB_SURFACE, path, nullptr, nullptr });
+}
+
+/**
+ * Queues a sound to be decoded to PCM.
+ * @param path The file path to the sound.
+ */
+void AssetLoader::addSound(const std::string& path) {
+    mJobs.push_back({ JOB_SOUND, path, nullptr, nullptr });
+}
+
+/**
+ * Sets the asset pack to load from before falling back to the loose files.
+ * @param pack The opened pack, or nullptr.
+ */
+void AssetLoader::setPack(std::shared_ptr<AssetPack> pack) {
+    mPack = pack;
+}
+
+/**
+ * Decodes all queued files on worker threads. Decoded images are uploaded and
+ * sounds registered on the calling thread as soon as each one is ready.
+ * @param progress Called after each finished file and periodically while waiting; may be empty.
+ * @param workerCount The number of worker threads, or 0 to pick one per spare core.
+ * @return True if every file was loaded, false otherwise.
+ */
+bool AssetLoader::load(const ProgressCallback& progress, int workerCount) {
+    Uint64 startCounter = SDL_GetPerformanceCounter();
+    int total = static_cast<int>(mJobs.size());
+
+    // Start the libraries up front; the workers must not initialize them concurrently
+    bool hasImages = false;
+    bool hasSounds = false;
+    for (const Job& job : mJobs) {
+        hasImages = hasImages || job.type != JOB_SOUND;
+        hasSounds = hasSounds || job.type == JOB_SOUND;
+    }
+    if (hasImages) {
+        Subsystems::ensureImage();
+    }
+    if (hasSounds) {
+        Subsystems::ensureAudio();
+    }
+
+    // Packed files need no decoding; only the rest go to the workers
+    bool success = true;
+    int completed = 0;
+    mPending.clear();
+    for (size_t i = 0; i < mJobs.size(); ++i) {
+        if (mPack && loadFromPack(mJobs[i])) {
+            ++completed;
+        }
+        else {
+            mPending.push_back(i);
+        }
+    }
+    int packed = completed;
+
+    if (workerCount <= 0) {
+        workerCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+    }
+    workerCount = std::min(workerCount, static_cast<int>(mPending.size()));
+
+    mNextJob = 0;
+    mCompleted.clear();
+    std::vector<std::thread> workers;
+    for (int i = 0; i < workerCount; ++i) {
+        try {
+            workers.push_back(std::thread(&AssetLoader::workerMain, this));
+        }
+        catch (const std::system_error& e) {
+            printf("Asset loader thread could not be started! Error: %s\n", e.what());
+            break;
+        }
+    }
+    if (workers.empty()) {
+        workerMain(); // Decode everything on this thread instead
+    }
+
+    std::vector<size_t> ready;
+    while (completed < total) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            // Wake up regularly so the progress callback can keep the window responsive
+            mJobDone.wait_for(lock, std::chrono::milliseconds(16), [this]() { return !mCompleted.empty(); });
+            ready.swap(mCompleted);
+        }
+        for (size_t index : ready) {
+            success = finishJob(mJobs[index]) && success;
+            ++completed;
+        }
+        ready.clear();
+        if (progress) {
+            progress(completed, total);
+        }
+    }
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+
+    double elapsedMs = (SDL_GetPerformanceCounter() - startCounter) * 1000.0 / SDL_GetPerformanceFrequency();
+    printf("Loaded %d assets (%d from pack) with %d threads in %.1f ms\n", total, packed, std::max(1, static_cast<int>(workers.size())), elapsedMs);
+    return success;
+}
+
+/**
+ * Worker thread entry point. Claims jobs until none are left and decodes them.
+ */
+void AssetLoader::workerMain() {
+    for (;;) {
+        size_t next = mNextJob++;
+        if (next >= mPending.size()) {
+            return;
+        }
+        size_t index = mPending[next];
+
+        PROFILE_ZONE("AssetLoader::decode");
+        Job& job = mJobs[index];
+        if (job.type == JOB_SOUND) {
+            job.chunk = Mix_LoadWAV(job.path.c_str());
+        }
+        else {
+            job.surface = IMG_Load(job.path.c_str());
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mCompleted.push_back(index);
+        }
+        mJobDone.notify_one();
+    }
+}
+
+/**
+ * Hands a decoded job over to the cache. Runs on the loading thread because
+ * textures can only be created on the thread that owns the renderer.
+ * @param job The decoded job.
+ * @return True if the asset was loaded, false otherwise.
+ */
+bool AssetLoader::finishJob(Job& job) {
+    if (job.type == JOB_SOUND) {
+        if (job.chunk == nullptr) {
+            printf("Failed to load sound %s!\n", job.path.c_str());
+            return false;
+        }
+        mSounds.push_back(mAssets->adoptSound(job.path, job.chunk));
+        job.chunk = nullptr;
+        return true;
+    }
+
+    if (job.surface == nullptr) {
+        printf("Unable to load image %s!\n", job.path.c_str());
+        return false;
+    }
+    if (job.type == JOB_SURFACE) {
+        auto it = mSurfaces.find(job.path);
+        if (it != mSurfaces.end()) {
+            SDL_FreeSurface(it->second.surface);
+        }
+        mSurfaces[job.path] = { job.surface, false };
+        job.surface = nullptr;
+        return true;
+    }
+
+    SDL_Texture* texture = mRenderer->createTexture(job.surface);
+    SDL_FreeSurface(job.surface);
+    job.surface = nullptr;
+    if (texture == nullptr) {
+        return false;
+    }
+    mTextures.push_back(mAssets->adoptTexture(job.path, texture));
+    return true;
+}
+
+/**
+ * Loads a job straight from the asset pack without decoding.
+ * Textures are uploaded from the mapping; surfaces and sounds point into it.
+ * @param job The job to load.
+ * @return True if the pack held the asset in a usable format, false otherwise.
+ */
+bool AssetLoader::loadFromPack(Job& job) {
+    const AssetPackEntry* entry = mPack->find(job.path);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    if (job.type == JOB_SOUND) {
+        Mix_Chunk* chunk = mPack->createChunk(*entry);
+        if (chunk == nullptr) {
+            return false;
+        }
+        mSounds.push_back(mAssets->adoptSound(job.path, chunk));
+        return true;
+    }
+
+    if (entry->type != ASSET_PACK_TEXTURE) {
+        return false;
+    }
+    if (job.type == JOB_SURFACE) {
+        SDL_Surface* surface = mPack->createSurface(*entry);
+        if (surface == nullptr) {
+            return false;
+        }
+        mSurfaces[job.path] = { surface, true };
+        return true;
+    }
+
+    SDL_Texture* texture = mRenderer->createStaticTexture(entry->format, entry->width, entry->height, mPack->getData(*entry), entry->pitch);
+    if (texture == nullptr) {
+        return false;
+    }
+    Renderer::setPremultipliedBlendMode(texture);
+    mTextures.push_back(mAssets->adoptTexture(job.path, texture));
+    return true;
+}
+
+/**
+ * Takes a surface decoded for addSurface.
+ * @param path The file path the surface was queued with.
+ * @param premultiplied Set to true if the surface colors are premultiplied by alpha; may be null.
+ * @return The surface, owned by the caller, or nullptr if it was not loaded.
+ */
+SDL_Surface* AssetLoader::takeSurface(const std::string& path, bool* premultiplied) {
+    auto it = mSurfaces.find(path);
+    if (it == mSurfaces.end()) {
+        return nullptr;
+    }
+    SDL_Surface* surface = it->second.surface;
+    if (premultiplied != nullptr) {
+        *premultiplied = it->second.premultiplied;
+    }
+    mSurfaces.erase(it);
+    return surface;
+}
@@ -0,0 +1,128 @@
+#include "AssetPack.h"
+#include <stdio.h>
+#include <cstring>
+
+/**
+ * Constructor for the AssetPack class.
+ */
+AssetPack::AssetPack() {}
+
+/**
+ * Destructor for the AssetPack class.
+ * Unmaps the pack; surfaces and sounds created from it must be freed first.
+ */
+AssetPack::~AssetPack() {}
+
+/**
+ * Maps a pack file and builds the name index.
+ * @param path The file path to the pack.
+ * @return True if the pack is valid, false otherwise.
+ */
+bool AssetPack::open(const std::string& path) {
+    mIndex.clear();
+    if (!mFile.open(path)) {
+        return false;
+    }
+
+    const Uint8* data = mFile.getData();
+    size_t size = mFile.getSize();
+    AssetPackHeader header;
+    if (size < sizeof(header)) {
+        printf("Asset pack %s is truncated!\n", path.c_str());
+        mFile.close();
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.magic != ASSET_PACK_MAGIC || header.version != ASSET_PACK_VERSION || header.entrySize != sizeof(AssetPackEntry)) {
+        printf("Asset pack %s has an unsupported format!\n", path.c_str());
+        mFile.close();
+        return false;
+    }
+    if (header.indexOffset % alignof(AssetPackEntry) != 0 || header.indexOffset > size ||
+        header.entryCount > (size - header.indexOffset) / sizeof(AssetPackEntry)) {
+        printf("Asset pack %s has a corrupt index!\n", path.c_str());
+        mFile.close();
+        return false;
+    }
+
+    const AssetPackEntry* entries = reinterpret_cast<const AssetPackEntry*>(data + header.indexOffset);
+    for (Uint32 i = 0; i < header.entryCount; ++i) {
+        const AssetPackEntry& entry = entries[i];
+        if (entry.offset > size || entry.size > size - entry.offset || entry.name[ASSET_PACK_NAME_LENGTH - 1] != '\0') {
+            printf("Skipping corrupt asset pack entry %u!\n", i);
+            continue;
+        }
+        mIndex[entry.name] = &entry;
+    }
+    return true;
+}
+
+/**
+ * Looks up an asset by name.
+ * @param name The path the asset was packed from.
+ * @return The entry, or nullptr if the pack does not contain it.
+ */
+const AssetPackEntry* AssetPack::find(const std::string& name) const {
+    auto it = mIndex.find(name);
+    return it != mIndex.end() ? it->second : nullptr;
+}
+
+/**
+ * Gets the contents of an asset inside the mapping.
+ * @param entry The entry returned by find.
+ * @return A pointer to the first byte of the asset.
+ */
+const Uint8* AssetPack::getData(const AssetPackEntry& entry) const {
+    return mFile.getData() + entry.offset;
+}
+
+/**
+ * Gets the number of valid assets in the pack.
+ * @return The entry count.
+ */
+size_t AssetPack::getEntryCount() const {
+    return mIndex.size();
+}
+
+/**
+ * Creates a surface that uses the texture pixels in the mapping directly.
+ * The surface must only be read from, e.g. as a blit source.
+ * @param entry A texture entry returned by find.
+ * @return The surface, or nullptr if the entry is not a texture.
+ */
+SDL_Surface* AssetPack::createSurface(const AssetPackEntry& entry) const {
+    if (entry.type != ASSET_PACK_TEXTURE) {
+        return nullptr;
+    }
+    void* pixels = const_cast<Uint8*>(getData(entry));
+    SDL_Surface* surface = SDL_CreateRGBSurfaceWithFormatFrom(pixels, entry.width, entry.height, 32, entry.pitch, entry.format);
+    if (surface == nullptr) {
+        printf("Unable to wrap packed image %s! SDL Error: %s\n", entry.name, SDL_GetError());
+    }
+    return surface;
+}
+
+/**
+ * Creates a sound chunk that plays the PCM in the mapping directly.
+ * The mixer must have been opened with the format the sound was packed in.
+ * @param entry A sound entry returned by find.
+ * @return The chunk, or nullptr if the entry is not a sound or the format differs.
+ */
+Mix_Chunk* AssetPack::createChunk(const AssetPackEntry& entry) const {
+    if (entry.type != ASSET_PACK_SOUND) {
+        return nullptr;
+    }
+    int frequency = 0;
+    Uint16 format = 0;
+    int channels = 0;
+    if (Mix_QuerySpec(&frequency, &format, &channels) == 0 ||
+        static_cast<Uint32>(frequency) != entry.width || format != entry.format || static_cast<Uint32>(channels) != entry.height) {
+        printf("Packed sound %s does not match the mixer format!\n", entry.name);
+        return nullptr;
+    }
+    Mix_Chunk* chunk = Mix_QuickLoad_RAW(const_cast<Uint8*>(getData(entry)), static_cast<Uint32>(entry.size));
+    if (chunk == nullptr) {
+        printf("Unable to wrap packed sound %s! SDL_mixer Error: %s\n", entry.name, Mix_GetError());
+    }
+    return chunk;
+}
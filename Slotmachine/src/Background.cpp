@@ -7,20 +7,16 @@
  * Constructor for the Background class.
  * Initializes the background with the given renderer.
  * @param renderer The SDL_Renderer to use for rendering.
+ * @param assets The AssetCache that provides the texture.
  */
-Background::Background(std::shared_ptr<Renderer> renderer)
-    : mRenderer(renderer), mTexture(NULL) {}
+Background::Background(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets)
+    : mRenderer(renderer), mAssets(assets), mTexture(NULL) {}
 
 /**
  * Destructor for the Background class.
- * Cleans up the loaded texture.
+ * The texture is released with the last handle to it.
  */
-Background::~Background() {
-    if (mTexture != NULL) {
-        SDL_DestroyTexture(mTexture);
-        mTexture = NULL;
-    }
-}
+Background::~Background() {}
 
 /**
  * Loads the background texture from the given file path.
@@ -28,26 +24,13 @@ Background::~Background() {
  * @return True if the texture was loaded successfully, false otherwise.
  */
 bool Background::loadMedia(const std::string& path) {
-    SDL_Surface* loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == NULL) {
-        printf("Unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
-        return false;
-    }
-
-    mTexture = SDL_CreateTextureFromSurface(mRenderer->getSDLRenderer(), loadedSurface);
-    SDL_FreeSurface(loadedSurface);
-
-    if (mTexture == NULL) {
-        printf("Unable to create texture from %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
-        return false;
-    }
-
-    return true;
+    mTexture = mAssets->getTexture(path);
+    return mTexture != NULL;
 }
 
 /**
  * Renders the background texture to the screen.
  */
 void Background::render() {
-    mRenderer->renderTexture(mTexture, NULL, NULL);
+    mRenderer->renderTexture(mTexture.get(), NULL, NULL);
 }
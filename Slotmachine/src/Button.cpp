@@ -1,4 +1,5 @@
 #include "Button.h"
+#include "Profiler.h"
 #include <SDL_ttf.h>
 #include <stdio.h>
 #include <iostream>
@@ -8,15 +9,17 @@
  * Constructor for the Button class.
  * Initializes the button with the given renderer, position, size, and text.
  * @param renderer The Renderer to use for rendering.
+ * @param textRenderer The TextRenderer used to draw the button label.
+ * @param assets The AssetCache that provides the click sound.
  * @param x The x-coordinate of the button.
  * @param y The y-coordinate of the button.
  * @param w The width of the button.
  * @param h The height of the button.
  * @param text The text to display on the button.
  */
-Button::Button(std::shared_ptr<Renderer> renderer, int x, int y, int w, int h, const std::string& text)
-    : mRenderer(renderer), mButtonRect{ x, y, w, h }, mText(text), mHighlighted(false),
-    mAnimationStartTime(SDL_GetTicks()), mClicked(false), mActive(true), mClickSound(nullptr)
+Button::Button(std::shared_ptr<Renderer> renderer, std::shared_ptr<TextRenderer> textRenderer, std::shared_ptr<AssetCache> assets, int x, int y, int w, int h, const std::string& text)
+    : mRenderer(renderer), mTextRenderer(textRenderer), mButtonRect{ x, y, w, h }, mText(text), mTextId(-1), mHighlighted(false),
+    mAnimationStartTime(0.0), mClicked(false), mActive(true), mClickSound(nullptr)
 {
     // Initialize colors
     mBaseColor = { 255, 0, 0, 255 }; // Red
@@ -24,44 +27,49 @@ Button::Button(std::shared_ptr<Renderer> renderer, int x, int y, int w, int h, c
     mInactiveColor = { 0, 255, 0, 255 }; // Green for inactive
     mCurrentColor = mBaseColor;
 
+    // Lay out the label once; the font and its glyph atlas are shared
+    TextRenderer::FontId font = mTextRenderer->loadFont("assets/fonts/FalloutFont.ttf", 26);
+    mTextId = mTextRenderer->prepareText(font, mText);
+
     // Load click sound
-    mClickSound = Mix_LoadWAV("assets/sounds/click2.mp3"); // Replace with your click sound file path
+    mClickSound = assets->getSound("assets/sounds/click2.mp3"); // Replace with your click sound file path
     if (!mClickSound) {
-        printf("Failed to load click sound effect! SDL_mixer Error: %s\n", Mix_GetError());
+        printf("Failed to load click sound effect!\n");
     }
 }
 
 /**
  * Destructor for the Button class.
- * Cleans up the loaded sound effect.
+ * The sound effect is released with the last handle to it.
  */
-Button::~Button() {
-    // Free sound effect
-    if (mClickSound) {
-        Mix_FreeChunk(mClickSound);
-        mClickSound = nullptr;
-    }
-}
+Button::~Button() {}
 
 /**
- * Renders the button, including its text.
+ * Updates the button color.
  * Animates the button if it is active.
+ * @param clock The frame clock, already ticked for this frame.
  */
-void Button::render() {
+void Button::update(const FrameClock& clock) {
     // Animate the button to change color
     if (mActive) {
-        animate();
+        animate(clock.getMs());
     }
     else {
         setColor(mInactiveColor); // Set inactive color
     }
+}
 
+/**
+ * Renders the button, including its text.
+ */
+void Button::render() {
+    PROFILE_ZONE("Button::render");
     // Set the color and fill the button rectangle
     mRenderer->setDrawColor(mCurrentColor.r, mCurrentColor.g, mCurrentColor.b, mCurrentColor.a);
     mRenderer->fillRect(mButtonRect);
 
     // Render button text
-    renderText(mText, mButtonRect.x + 10, mButtonRect.y + 10);
+    renderText();
 }
 
 /**
@@ -69,28 +77,25 @@ void Button::render() {
  * @param color The new color of the button.
  */
 void Button::setColor(const SDL_Color& color) {
+    if (color.r != mCurrentColor.r || color.g != mCurrentColor.g || color.b != mCurrentColor.b || color.a != mCurrentColor.a) {
+        mRenderer->invalidate(mButtonRect);
+    }
     mCurrentColor = color;
 }
 
 /**
- * Renders the text on the button.
- * @param text The text to render.
- * @param x The x-coordinate where the text should be rendered.
- * @param y The y-coordinate where the text should be rendered.
+ * Gets the rectangle of the button.
+ * @return The button rectangle.
  */
-void Button::renderText(const std::string& text, int x, int y) {
-    // Load font
-    TTF_Font* font = TTF_OpenFont("assets/fonts/FalloutFont.ttf", 26); // Replace with your font and size
-    if (!font) {
-        printf("Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
-        return;
-    }
+const SDL_Rect& Button::getRect() const {
+    return mButtonRect;
+}
 
-    // Render text using the Renderer class
-    SDL_Color textColor = { 0, 0, 0, 255 }; // Black text
-    SDL_Texture* textTexture = mRenderer->renderText(text, font, textColor);
-    if (!textTexture) {
-        TTF_CloseFont(font);
+/**
+ * Renders the cached button label centered in the button.
+ */
+void Button::renderText() {
+    if (mTextId < 0) {
         return;
     }
 
@@ -98,37 +103,41 @@ void Button::renderText(const std::string& text, int x, int y) {
     int centerX = mButtonRect.x + (mButtonRect.w / 2);
     int centerY = mButtonRect.y + (mButtonRect.h / 2);
 
-    // Get text dimensions
-    int textWidth, textHeight;
-    SDL_QueryTexture(textTexture, nullptr, nullptr, &textWidth, &textHeight);
-
     // Adjust the x and y coordinates to center the text
-    int renderX = centerX - (textWidth / 2);
-    int renderY = centerY - (textHeight / 2);
-
-    // Set rendering space and render to screen
-    SDL_Rect renderQuad = { renderX, renderY, textWidth, textHeight };
-    mRenderer->renderTexture(textTexture, nullptr, &renderQuad);
+    int renderX = centerX - (mTextRenderer->getTextWidth(mTextId) / 2);
+    int renderY = centerY - (mTextRenderer->getTextHeight(mTextId) / 2);
 
-    // Clean up
-    SDL_DestroyTexture(textTexture);
-    TTF_CloseFont(font);
+    SDL_Color textColor = { 0, 0, 0, 255 }; // Black text
+    mTextRenderer->drawText(mTextId, renderX, renderY, textColor);
 }
 
 /**
  * Animates the button by changing its color periodically.
+ * @param now The frame clock time in milliseconds.
  */
-void Button::animate() {
-    Uint32 currentTime = SDL_GetTicks();
-    Uint32 elapsedTime = currentTime - mAnimationStartTime;
+void Button::animate(double now) {
+    double elapsedTime = now - mAnimationStartTime;
 
     if (elapsedTime > mAnimationDuration) {
-        mAnimationStartTime = currentTime;
+        mAnimationStartTime = now;
         setColor(mHighlighted ? mBaseColor : mHighlightColor);
         mHighlighted = !mHighlighted;
     }
 }
 
+/**
+ * Gets the time until the blink animation next changes the button color.
+ * @param clock The frame clock, ticked at the time to measure from.
+ * @return The time in milliseconds, rounded up, or SDL_MAX_UINT32 if the button is inactive.
+ */
+Uint32 Button::getMsUntilNextChange(const FrameClock& clock) const {
+    if (!mActive) {
+        return SDL_MAX_UINT32;
+    }
+    double elapsedTime = clock.getMs() - mAnimationStartTime;
+    return elapsedTime > mAnimationDuration ? 0 : static_cast<Uint32>(mAnimationDuration - elapsedTime) + 1;
+}
+
 /**
  * Handles SDL events for the button, such as mouse clicks.
  * @param e The SDL_Event to handle.
@@ -172,7 +181,7 @@ void Button::resetClick() {
 void Button::setActive(bool active) {
     mActive = active;
     if (active) {
-        mCurrentColor = mBaseColor; // Reset to base color when activated
+        setColor(mBaseColor); // Reset to base color when activated
     }
 }
 
@@ -181,7 +190,7 @@ void Button::setActive(bool active) {
  */
 void Button::playClickSound() {
     if (mClickSound) {
-        if (Mix_PlayChannel(-1, mClickSound, 0) == -1) {
+        if (Mix_PlayChannel(-1, mClickSound.get(), 0) == -1) {
             printf("Failed to play sound! SDL_mixer Error: %s\n", Mix_GetError());
         }
     }
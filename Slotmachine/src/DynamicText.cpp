@@ -0,0 +1,138 @@
+#include "DynamicText.h"
+#include <stdio.h>
+#include <algorithm>
+
+/**
+ * Constructor for the DynamicText class.
+ * The texture is created by the first setText call.
+ * @param renderer The custom Renderer used to create, update and draw the texture.
+ * @param font The TTF_Font to render the text with; the caller keeps it open.
+ */
+DynamicText::DynamicText(std::shared_ptr<Renderer> renderer, TTF_Font* font)
+    : mRenderer(renderer), mFont(font), mTexture(nullptr), mTextureWidth(0), mTextureHeight(0),
+    mWidth(0), mHeight(0), mColor{ 0, 0, 0, 0 } {}
+
+/**
+ * Destructor for the DynamicText class.
+ * Destroys the streaming texture.
+ */
+DynamicText::~DynamicText() {
+    if (mTexture != nullptr) {
+        SDL_DestroyTexture(mTexture);
+    }
+}
+
+/**
+ * Renders new text and uploads it into the streaming texture, growing the
+ * texture first if the text does not fit.
+ * @param text The text to show; an empty string shows nothing.
+ * @param color The color of the text.
+ * @return True if the text was updated, false otherwise.
+ */
+bool DynamicText::setText(const std::string& text, SDL_Color color) {
+    if (text == mText && color.r == mColor.r && color.g == mColor.g && color.b == mColor.b && color.a == mColor.a) {
+        return true;
+    }
+
+    if (text.empty()) {
+        mText = text;
+        mColor = color;
+        mWidth = 0;
+        mHeight = 0;
+        return true;
+    }
+
+    SDL_Surface* textSurface = TTF_RenderText_Blended(mFont, text.c_str(), color);
+    if (textSurface == nullptr) {
+        printf("Unable to render text surface! SDL_ttf Error: %s\n", TTF_GetError());
+        return false;
+    }
+
+    // Blended text is already ARGB8888; convert only if this SDL_ttf differs
+    if (textSurface->format->format != SDL_PIXELFORMAT_ARGB8888) {
+        SDL_Surface* converted = SDL_ConvertSurfaceFormat(textSurface, SDL_PIXELFORMAT_ARGB8888, 0);
+        SDL_FreeSurface(textSurface);
+        textSurface = converted;
+        if (textSurface == nullptr) {
+            printf("Unable to convert text surface! SDL Error: %s\n", SDL_GetError());
+            return false;
+        }
+    }
+
+    bool success = reserve(textSurface->w, textSurface->h);
+    if (success) {
+        SDL_Rect rect = { 0, 0, textSurface->w, textSurface->h };
+        success = mRenderer->updateTexture(mTexture, &rect, textSurface->pixels, textSurface->pitch);
+    }
+    if (success) {
+        mText = text;
+        mColor = color;
+        mWidth = textSurface->w;
+        mHeight = textSurface->h;
+    }
+    SDL_FreeSurface(textSurface);
+    return success;
+}
+
+/**
+ * Makes sure the streaming texture can hold text of the given size.
+ * Sizes are rounded up to buckets so a counter that gains a digit
+ * usually still fits.
+ * @param width The text width in pixels.
+ * @param height The text height in pixels.
+ * @return True if the texture is large enough, false if it could not be created.
+ */
+bool DynamicText::reserve(int width, int height) {
+    if (mTexture != nullptr && width <= mTextureWidth && height <= mTextureHeight) {
+        return true;
+    }
+
+    int textureWidth = std::max(static_cast<int>(MIN_TEXTURE_WIDTH), mTextureWidth);
+    while (textureWidth < width) {
+        textureWidth *= 2;
+    }
+    int textureHeight = std::max(mTextureHeight, (height + HEIGHT_BUCKET - 1) / HEIGHT_BUCKET * HEIGHT_BUCKET);
+
+    SDL_Texture* texture = mRenderer->createStreamingTexture(textureWidth, textureHeight);
+    if (texture == nullptr) {
+        return false;
+    }
+    mRenderer->setTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    if (mTexture != nullptr) {
+        SDL_DestroyTexture(mTexture);
+    }
+    mTexture = texture;
+    mTextureWidth = textureWidth;
+    mTextureHeight = textureHeight;
+    return true;
+}
+
+/**
+ * Renders the current text.
+ * @param x The x-coordinate of the top-left corner of the text.
+ * @param y The y-coordinate of the top-left corner of the text.
+ */
+void DynamicText::render(int x, int y) {
+    if (mTexture == nullptr || mWidth == 0) return;
+
+    SDL_Rect src = { 0, 0, mWidth, mHeight };
+    SDL_Rect dst = { x, y, mWidth, mHeight };
+    mRenderer->renderTexture(mTexture, &src, &dst);
+}
+
+/**
+ * Gets the width of the current text.
+ * @return The width in pixels.
+ */
+int DynamicText::getWidth() const {
+    return mWidth;
+}
+
+/**
+ * Gets the height of the current text.
+ * @return The height in pixels.
+ */
+int DynamicText::getHeight() const {
+    return mHeight;
+}
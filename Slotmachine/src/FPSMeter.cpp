@@ -2,15 +2,20 @@
 #include <SDL_ttf.h>
 #include <stdio.h>
 #include <sstream>
+#include <algorithm>
 
 /**
  * Constructor for the FPSMeter class.
  * Initializes the FPS meter with the given renderer and font.
  * @param renderer The custom Renderer to use for rendering.
  * @param font The TTF_Font to use for rendering text.
+ * @param detailFont The TTF_Font to use for the renderer call counts.
  */
-FPSMeter::FPSMeter(std::shared_ptr<Renderer> renderer, TTF_Font* font)
-    : mRenderer(renderer), gFont(font), frameCount(0), startTime(0), fpsTexture(renderer->getSDLRenderer()) {
+FPSMeter::FPSMeter(std::shared_ptr<Renderer> renderer, TTF_Font* font, TTF_Font* detailFont)
+    : mRenderer(renderer), frameCount(0), startTime(0.0), fpsTexture(renderer, font),
+    statsTexture(renderer, font), countersTexture(renderer, detailFont), mPosition{ 0, 0 }, mLastRect{ 0, 0, 0, 0 },
+    mLastFrameCounter(0), mGraphNext(0), mDetailsVisible(false) {
+    std::fill(mGraphMs, mGraphMs + GRAPH_SAMPLES, 0.0f);
 }
 
 /**
@@ -23,41 +28,230 @@ FPSMeter::~FPSMeter() {
 }
 
 /**
- * Starts the FPS meter by initializing the start time and frame count.
+ * Starts the FPS meter by initializing the start time and frame count,
+ * and clears the frame time statistics.
+ * @param clock The frame clock.
  */
-void FPSMeter::start() {
-    startTime = SDL_GetTicks();
+void FPSMeter::start(const FrameClock& clock) {
+    startTime = clock.getMs();
     frameCount = 0;
+    mHistogram.reset();
+    mLastFrameCounter = 0;
 }
 
 /**
- * Updates the FPS meter by incrementing the frame count and calculating the FPS.
- * If one second has passed, it updates the FPS texture with the new FPS value.
+ * Updates the FPS meter by incrementing the frame count and recording the time
+ * since the previous frame. If one second has passed, it updates the text with
+ * the new FPS value, the average share of the screen repainted per frame,
+ * the frame time percentiles and the renderer calls of the last presented frame.
+ * @param clock The frame clock, already ticked for this frame.
  */
-void FPSMeter::update() {
+void FPSMeter::update(const FrameClock& clock) {
+    Uint64 counter = clock.getCounter();
+    if (mLastFrameCounter != 0) {
+        double frameMs = clock.toMs(counter - mLastFrameCounter);
+        mHistogram.record(static_cast<Uint64>(frameMs * 1000.0));
+
+        mGraphMs[mGraphNext] = static_cast<float>(frameMs);
+        mGraphNext = (mGraphNext + 1) % GRAPH_SAMPLES;
+        if (mDetailsVisible) {
+            mRenderer->invalidate(getGraphRect());
+        }
+    }
+    mLastFrameCounter = counter;
+
     frameCount++;
-    Uint32 currentTime = SDL_GetTicks();
-    if (currentTime - startTime >= 1000) {
-        int fps = frameCount / ((currentTime - startTime) / 1000);
+    double currentTime = clock.getMs();
+    if (currentTime - startTime >= 1000.0) {
+        double fps = frameCount * 1000.0 / (currentTime - startTime);
         std::stringstream ss;
-        ss << "FPS: " << fps;
+        ss.setf(std::ios::fixed);
+        ss.precision(1);
+        ss << "FPS: " << fps << "  Repaint: " << mRenderer->getAverageRepaintPercent() << "%";
+        mRenderer->resetRepaintStats();
 
-        // Render text to texture
+        FrameStats stats = getStats();
+        std::stringstream statsText;
+        statsText.setf(std::ios::fixed);
+        statsText.precision(1);
+        statsText << "ms  p50: " << stats.p50Ms << "  p95: " << stats.p95Ms
+            << "  p99: " << stats.p99Ms << "  max: " << stats.maxMs;
+
+        const RenderStats& calls = mRenderer->getFrameStats();
+        std::stringstream countersText;
+        countersText << "Draws " << calls.getDrawCalls() << ": copy " << calls.copies
+            << " geom " << calls.geometryBatches << " (" << calls.batchedQuads << " quads) fill " << calls.fillRects
+            << " line " << calls.lines << " clear " << calls.clears
+            << " | State " << calls.getStateChanges() << ": color " << calls.drawColorChanges
+            << " clip " << calls.clipRectChanges << " target " << calls.targetChanges
+            << " tex " << calls.textureSwitches << " mod " << calls.textureModChanges
+            << " skip " << calls.skippedStateChanges << " upload " << calls.textureUploads;
+
+        // Upload the text into the streaming textures
         SDL_Color textColor = { 255, 255, 255, 255 }; // White color
-        if (!fpsTexture.loadFromRenderedText(ss.str(), textColor, gFont)) {
+        if (!fpsTexture.setText(ss.str(), textColor)
+            || !statsTexture.setText(statsText.str(), textColor)
+            || !countersTexture.setText(countersText.str(), textColor)) {
             printf("Unable to render FPS texture!\n");
         }
 
+        // Repaint the area covered by both the old and the new text
+        mRenderer->invalidate(mLastRect);
+        mLastRect = getBounds();
+        mRenderer->invalidate(mLastRect);
+
         startTime = currentTime;
         frameCount = 0;
     }
 }
 
 /**
- * Renders the FPS texture at the specified position.
+ * Forgets when the last frame was shown, so the time spent waiting for
+ * events while idle is not recorded as one long frame.
+ */
+void FPSMeter::resume() {
+    mLastFrameCounter = 0;
+}
+
+/**
+ * Gets the time until update() next refreshes the FPS texture.
+ * @param clock The frame clock, ticked at the time to measure from.
+ * @return The time in milliseconds, rounded up.
+ */
+Uint32 FPSMeter::getMsUntilNextUpdate(const FrameClock& clock) const {
+    double elapsed = clock.getMs() - startTime;
+    return elapsed >= 1000.0 ? 0 : static_cast<Uint32>(1000.0 - elapsed) + 1;
+}
+
+/**
+ * Shows or hides the renderer call counts and the frame time graph.
+ * @param visible True to draw the details above the text.
+ */
+void FPSMeter::setDetailsVisible(bool visible) {
+    if (visible == mDetailsVisible) return;
+    mDetailsVisible = visible;
+    mRenderer->invalidate(mLastRect);
+    mLastRect = getBounds();
+    mRenderer->invalidate(mLastRect);
+}
+
+/**
+ * Checks if the renderer call counts and the frame time graph are drawn.
+ * @return True if the details are visible, false otherwise.
+ */
+bool FPSMeter::isDetailsVisible() const {
+    return mDetailsVisible;
+}
+
+/**
+ * Summarizes the frame times recorded since start(). Percentiles are
+ * accurate to about 3%; the average and maximum are exact.
+ * @return The frame time statistics in milliseconds.
+ */
+FrameStats FPSMeter::getStats() const {
+    FrameStats stats;
+    stats.frameCount = mHistogram.getCount();
+    stats.averageMs = mHistogram.getMean() / 1000.0;
+    stats.p50Ms = mHistogram.getPercentile(50.0) / 1000.0;
+    stats.p95Ms = mHistogram.getPercentile(95.0) / 1000.0;
+    stats.p99Ms = mHistogram.getPercentile(99.0) / 1000.0;
+    stats.maxMs = mHistogram.getMax() / 1000.0;
+    return stats;
+}
+
+/**
+ * Prints the frame time statistics to the console.
+ */
+void FPSMeter::printStats() const {
+    FrameStats stats = getStats();
+    printf("Frame times over %llu frames: avg %.2f ms, p50 %.2f ms, p95 %.2f ms, p99 %.2f ms, max %.2f ms\n",
+        static_cast<unsigned long long>(stats.frameCount), stats.averageMs,
+        stats.p50Ms, stats.p95Ms, stats.p99Ms, stats.maxMs);
+}
+
+/**
+ * Gets the top of the renderer call counts, above the percentile line.
+ * @return The y-coordinate in screen coordinates.
+ */
+int FPSMeter::getCountersY() const {
+    return mPosition.y - statsTexture.getHeight() - LINE_SPACING - countersTexture.getHeight() - LINE_SPACING;
+}
+
+/**
+ * Gets the area of the frame time graph, above the renderer call counts.
+ * @return The graph rectangle in screen coordinates.
+ */
+SDL_Rect FPSMeter::getGraphRect() const {
+    int top = getCountersY() - GRAPH_HEIGHT - LINE_SPACING;
+    return { mPosition.x, top, GRAPH_SAMPLES * GRAPH_BAR_WIDTH, GRAPH_HEIGHT };
+}
+
+/**
+ * Gets the area covered by the text lines and, if visible, the details.
+ * @return The bounding rectangle in screen coordinates.
+ */
+SDL_Rect FPSMeter::getBounds() const {
+    int top = mDetailsVisible ? getGraphRect().y : mPosition.y - statsTexture.getHeight() - LINE_SPACING;
+    int width = std::max(fpsTexture.getWidth(), statsTexture.getWidth());
+    if (mDetailsVisible) {
+        width = std::max(width, std::max(countersTexture.getWidth(), static_cast<int>(GRAPH_SAMPLES * GRAPH_BAR_WIDTH)));
+    }
+    return { mPosition.x, top, width, mPosition.y + fpsTexture.getHeight() - top };
+}
+
+/**
+ * Draws the recent frame times as bars, oldest on the left, with reference
+ * lines at the 60 and 30 FPS frame budgets. Bars are green within the 60 FPS
+ * budget, yellow within the 30 FPS budget and red beyond it.
+ * @param rect The graph rectangle.
+ */
+void FPSMeter::renderGraph(const SDL_Rect& rect) {
+    mRenderer->setDrawColor(0, 0, 0, 255);
+    mRenderer->fillRect(rect);
+
+    const float pixelsPerMs = static_cast<float>(GRAPH_HEIGHT) / GRAPH_RANGE_MS;
+    for (int i = 0; i < GRAPH_SAMPLES; ++i) {
+        float frameMs = mGraphMs[(mGraphNext + i) % GRAPH_SAMPLES];
+        if (frameMs <= 0.0f) continue;
+
+        int height = std::min(static_cast<int>(frameMs * pixelsPerMs + 0.5f), static_cast<int>(GRAPH_HEIGHT));
+        if (frameMs <= 1000.0f / 60.0f + 0.5f) {
+            mRenderer->setDrawColor(64, 200, 64, 255);
+        }
+        else if (frameMs <= 1000.0f / 30.0f + 0.5f) {
+            mRenderer->setDrawColor(230, 200, 40, 255);
+        }
+        else {
+            mRenderer->setDrawColor(230, 50, 50, 255);
+        }
+        SDL_Rect bar = { rect.x + i * GRAPH_BAR_WIDTH, rect.y + rect.h - height, GRAPH_BAR_WIDTH, height };
+        mRenderer->fillRect(bar);
+    }
+
+    mRenderer->setDrawColor(255, 255, 255, 255);
+    for (float budgetMs : { 1000.0f / 60.0f, 1000.0f / 30.0f }) {
+        int lineY = rect.y + rect.h - static_cast<int>(budgetMs * pixelsPerMs + 0.5f);
+        mRenderer->drawLine(rect.x, lineY, rect.x + rect.w - 1, lineY);
+    }
+}
+
+/**
+ * Renders the FPS text at the specified position, the percentiles above it
+ * and, if visible, the renderer call counts and the frame time graph above both.
  * @param x The x-coordinate where the FPS texture should be rendered.
  * @param y The y-coordinate where the FPS texture should be rendered.
  */
 void FPSMeter::render(int x, int y) {
+    if (x != mPosition.x || y != mPosition.y) {
+        mPosition = { x, y };
+        mRenderer->invalidate(mLastRect);
+        mLastRect = getBounds();
+        mRenderer->invalidate(mLastRect);
+    }
+    if (mDetailsVisible) {
+        renderGraph(getGraphRect());
+        countersTexture.render(x, getCountersY());
+    }
+    statsTexture.render(x, y - statsTexture.getHeight() - LINE_SPACING);
     fpsTexture.render(x, y); // Ensure that fpsTexture is compatible with mRenderer
 }
@@ -1,4 +1,5 @@
 #include "Frame.h"
+#include "Profiler.h"
 #include <SDL_image.h>
 #include <iostream>
 #include <Constants.h>
@@ -7,10 +8,11 @@
  * Constructor for the Frame class.
  * Initializes the frame with the given renderer and border width.
  * @param renderer The custom Renderer to use for rendering.
+ * @param assets The AssetCache that provides the textures.
  * @param borderWidth The width of the border.
  */
-Frame::Frame(std::shared_ptr<Renderer> renderer, int borderWidth)
-    : mRenderer(renderer), mBorderWidth(borderWidth), mBottomHeight(198), mBottomTexture(nullptr), mHeaderTexture(nullptr) {
+Frame::Frame(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets, int borderWidth)
+    : mRenderer(renderer), mAssets(assets), mBorderWidth(borderWidth), mBottomHeight(198), mBottomTexture(nullptr), mHeaderTexture(nullptr) {
     mRect.x = 0;
     mRect.y = 0;
     mRect.w = 100; // Default width
@@ -19,21 +21,9 @@ Frame::Frame(std::shared_ptr<Renderer> renderer, int borderWidth)
 
 /**
  * Destructor for the Frame class.
- * Cleans up the loaded textures.
+ * The textures are released with the last handle to them.
  */
-Frame::~Frame() {
-    // Clean up the bottom texture
-    if (mBottomTexture != nullptr) {
-        SDL_DestroyTexture(mBottomTexture);
-        mBottomTexture = nullptr;
-    }
-
-    // Clean up the header texture
-    if (mHeaderTexture != nullptr) {
-        SDL_DestroyTexture(mHeaderTexture);
-        mHeaderTexture = nullptr;
-    }
-}
+Frame::~Frame() {}
 
 /**
  * Sets the dimensions of the frame.
@@ -53,28 +43,7 @@ void Frame::setDimensions(int width, int height) {
  * @return True if the texture was loaded successfully, false otherwise.
  */
 bool Frame::loadBottomTexture(const std::string& path) {
-    // Clean up any existing texture
-    if (mBottomTexture != nullptr) {
-        SDL_DestroyTexture(mBottomTexture);
-        mBottomTexture = nullptr;
-    }
-
-    // Load image at specified path
-    SDL_Surface* loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == nullptr) {
-        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
-        return false;
-    }
-
-    // Create texture from surface pixels
-    mBottomTexture = SDL_CreateTextureFromSurface(mRenderer->getSDLRenderer(), loadedSurface);
-    if (mBottomTexture == nullptr) {
-        std::cerr << "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << std::endl;
-    }
-
-    // Get rid of old loaded surface
-    SDL_FreeSurface(loadedSurface);
-
+    mBottomTexture = mAssets->getTexture(path);
     return mBottomTexture != nullptr;
 }
 
@@ -84,28 +53,7 @@ bool Frame::loadBottomTexture(const std::string& path) {
  * @return True if the texture was loaded successfully, false otherwise.
  */
 bool Frame::loadHeaderTexture(const std::string& path) {
-    // Clean up any existing texture
-    if (mHeaderTexture != nullptr) {
-        SDL_DestroyTexture(mHeaderTexture);
-        mHeaderTexture = nullptr;
-    }
-
-    // Load image at specified path
-    SDL_Surface* loadedSurface = IMG_Load(path.c_str());
-    if (loadedSurface == nullptr) {
-        std::cerr << "Unable to load image " << path << "! SDL_image Error: " << IMG_GetError() << std::endl;
-        return false;
-    }
-
-    // Create texture from surface pixels
-    mHeaderTexture = SDL_CreateTextureFromSurface(mRenderer->getSDLRenderer(), loadedSurface);
-    if (mHeaderTexture == nullptr) {
-        std::cerr << "Unable to create texture from " << path << "! SDL Error: " << SDL_GetError() << std::endl;
-    }
-
-    // Get rid of old loaded surface
-    SDL_FreeSurface(loadedSurface);
-
+    mHeaderTexture = mAssets->getTexture(path);
     return mHeaderTexture != nullptr;
 }
 
@@ -113,6 +61,7 @@ bool Frame::loadHeaderTexture(const std::string& path) {
  * Renders the frame, including its border, lines, bottom, and header.
  */
 void Frame::render() {
+    PROFILE_ZONE("Frame::render");
     drawBorder();
     drawLines();
     drawBottom();
@@ -162,7 +111,7 @@ void Frame::drawHeader() {
 
     if (mHeaderTexture != nullptr) {
         // Draw the texture in the header section
-        mRenderer->renderTexture(mHeaderTexture, nullptr, &headerRect);
+        mRenderer->renderTexture(mHeaderTexture.get(), nullptr, &headerRect);
     }
     else {
         // If no texture, draw a black rectangle as the background
@@ -191,7 +140,7 @@ void Frame::drawBottom() {
 
     if (mBottomTexture != nullptr) {
         // Draw the texture in the bottom section
-        mRenderer->renderTexture(mBottomTexture, nullptr, &bottomRect);
+        mRenderer->renderTexture(mBottomTexture.get(), nullptr, &bottomRect);
     }
     else {
         // If no texture, draw a black rectangle as the background
@@ -0,0 +1,42 @@
+#include "FrameClock.h"
+
+/**
+ * Constructor for the FrameClock class.
+ * The clock starts at zero and is already ticked once.
+ */
+FrameClock::FrameClock()
+    : mFrequency(SDL_GetPerformanceFrequency()), mOrigin(SDL_GetPerformanceCounter()),
+    mCounter(mOrigin) {}
+
+/**
+ * Samples the performance counter. Everything that reads the clock until
+ * the next tick gets this same time.
+ */
+void FrameClock::tick() {
+    mCounter = SDL_GetPerformanceCounter();
+}
+
+/**
+ * Gets the performance counter value sampled by the last tick.
+ * @return The counter value.
+ */
+Uint64 FrameClock::getCounter() const {
+    return mCounter;
+}
+
+/**
+ * Gets the time of the last tick.
+ * @return The time in milliseconds since the clock was created.
+ */
+double FrameClock::getMs() const {
+    return toMs(mCounter - mOrigin);
+}
+
+/**
+ * Converts a difference of performance counter values to milliseconds.
+ * @param counterDelta The difference in counter ticks.
+ * @return The time in milliseconds.
+ */
+double FrameClock::toMs(Uint64 counterDelta) const {
+    return counterDelta * 1000.0 / mFrequency;
+}
@@ -0,0 +1,219 @@
+#include "FrameScheduler.h"
+#include <stdio.h>
+#include <cmath>
+
+// Time the OS scheduler may overshoot SDL_Delay by; the rest is spent yielding
+static const double SLEEP_MARGIN_MS = 2.0;
+
+// Longest stretch of time simulated in one frame, to avoid a spiral of catch-up steps
+static const double MAX_ACCUMULATED_MS = 250.0;
+
+/**
+ * Constructor for the FrameScheduler class.
+ * @param simulationStepMs The fixed simulation step in milliseconds, or 0 to only pace frames.
+ * @param targetFrameRate The target frame rate, or 0 for unlimited.
+ */
+FrameScheduler::FrameScheduler(double simulationStepMs, int targetFrameRate)
+    : mFrequency(SDL_GetPerformanceFrequency()), mStepCounts(0), mFramePeriod(0), mVSync(false),
+    mFrameStart(0), mLastFrameStart(0), mDeadline(0), mAccumulator(0),
+    mFrameTimeMs(0.0), mDeadlineErrorMs(0.0), mMaxDeadlineErrorMs(0.0), mDeadlineErrorSumMs(0.0),
+    mFrameCount(0), mMissedDeadlines(0) {
+    if (simulationStepMs > 0.0) {
+        mStepCounts = fromMs(simulationStepMs);
+        if (mStepCounts == 0) {
+            mStepCounts = 1;
+        }
+    }
+    setTargetFrameRate(targetFrameRate);
+}
+
+/**
+ * Sets the target frame rate.
+ * @param framesPerSecond The target frame rate, or 0 for unlimited.
+ */
+void FrameScheduler::setTargetFrameRate(int framesPerSecond) {
+    mFramePeriod = framesPerSecond > 0 ? mFrequency / framesPerSecond : 0;
+}
+
+/**
+ * Tells the scheduler whether presents are synchronized to the display.
+ * @param enabled True if vsync is enabled.
+ */
+void FrameScheduler::setVSync(bool enabled) {
+    mVSync = enabled;
+}
+
+/**
+ * Starts a frame: samples the clock and accumulates the elapsed time for the simulation.
+ */
+void FrameScheduler::beginFrame() {
+    beginFrame(SDL_GetPerformanceCounter());
+}
+
+/**
+ * Starts a frame at a time already sampled by the caller and accumulates the
+ * elapsed time for the simulation.
+ * @param now The performance counter value at the start of the frame.
+ */
+void FrameScheduler::beginFrame(Uint64 now) {
+    mFrameStart = now;
+    if (mLastFrameStart == 0) {
+        mLastFrameStart = mFrameStart;
+        mDeadline = mFrameStart + mFramePeriod;
+    }
+
+    Uint64 elapsed = mFrameStart - mLastFrameStart;
+    mLastFrameStart = mFrameStart;
+    mFrameTimeMs = toMs(elapsed);
+
+    if (mStepCounts == 0) {
+        return; // Pacing only
+    }
+    mAccumulator += elapsed;
+    Uint64 maxAccumulated = fromMs(MAX_ACCUMULATED_MS);
+    if (mAccumulator > maxAccumulated) {
+        mAccumulator = maxAccumulated;
+    }
+}
+
+/**
+ * Consumes one fixed simulation step from the accumulator.
+ * @return True if a step is due, false once the accumulator is below one step.
+ */
+bool FrameScheduler::stepSimulation() {
+    if (mStepCounts == 0 || mAccumulator < mStepCounts) {
+        return false;
+    }
+    mAccumulator -= mStepCounts;
+    return true;
+}
+
+/**
+ * Finishes a frame. Unless vsync already paced a presented frame, sleeps for
+ * the bulk of the remaining budget and yields for the last couple of milliseconds.
+ * Then records how far the frame ended from its deadline.
+ * @param presented True if the frame was presented, false if it was skipped.
+ */
+void FrameScheduler::endFrame(bool presented) {
+    Uint64 now = SDL_GetPerformanceCounter();
+    bool paced = mVSync && presented;
+
+    if (mFramePeriod == 0 || paced) {
+        mDeadline = now;
+        mDeadlineErrorMs = 0.0;
+    }
+    else {
+        while (now < mDeadline) {
+            double remainingMs = toMs(mDeadline - now);
+            if (remainingMs > SLEEP_MARGIN_MS) {
+                SDL_Delay(static_cast<Uint32>(remainingMs - SLEEP_MARGIN_MS));
+            }
+            else {
+                SDL_Delay(0); // Yield the rest of the time slice
+            }
+            now = SDL_GetPerformanceCounter();
+        }
+
+        mDeadlineErrorMs = toMs(now - mDeadline);
+        if (now - mDeadline > mFramePeriod) {
+            // More than a frame late: resynchronize instead of rushing to catch up
+            mMissedDeadlines++;
+            mDeadline = now + mFramePeriod;
+        }
+        else {
+            if (now - mDeadline > mFramePeriod / 10) {
+                mMissedDeadlines++;
+            }
+            mDeadline += mFramePeriod;
+        }
+    }
+
+    mFrameCount++;
+    mDeadlineErrorSumMs += std::fabs(mDeadlineErrorMs);
+    if (mDeadlineErrorMs > mMaxDeadlineErrorMs) {
+        mMaxDeadlineErrorMs = mDeadlineErrorMs;
+    }
+}
+
+/**
+ * Drops accumulated simulation time and restarts the deadline sequence.
+ */
+void FrameScheduler::reset() {
+    mLastFrameStart = 0;
+    mAccumulator = 0;
+}
+
+/**
+ * Gets the duration of the last frame.
+ * @return The frame time in milliseconds.
+ */
+double FrameScheduler::getFrameTimeMs() const {
+    return mFrameTimeMs;
+}
+
+/**
+ * Gets how far the last frame ended from its deadline.
+ * @return The error in milliseconds; positive if the frame was late.
+ */
+double FrameScheduler::getDeadlineErrorMs() const {
+    return mDeadlineErrorMs;
+}
+
+/**
+ * Gets the largest deadline error seen so far.
+ * @return The error in milliseconds.
+ */
+double FrameScheduler::getMaxDeadlineErrorMs() const {
+    return mMaxDeadlineErrorMs;
+}
+
+/**
+ * Gets the mean absolute deadline error.
+ * @return The error in milliseconds.
+ */
+double FrameScheduler::getMeanDeadlineErrorMs() const {
+    return mFrameCount > 0 ? mDeadlineErrorSumMs / mFrameCount : 0.0;
+}
+
+/**
+ * Gets the number of frames finished.
+ * @return The frame count.
+ */
+Uint64 FrameScheduler::getFrameCount() const {
+    return mFrameCount;
+}
+
+/**
+ * Gets the number of frames that ended more than a tenth of a frame past their deadline.
+ * @return The missed deadline count.
+ */
+Uint64 FrameScheduler::getMissedDeadlines() const {
+    return mMissedDeadlines;
+}
+
+/**
+ * Prints a summary of the frame pacing statistics.
+ */
+void FrameScheduler::printStats() const {
+    printf("Frame pacing: %llu frames, %llu missed deadlines, mean error %.3f ms, max late %.3f ms\n",
+        static_cast<unsigned long long>(mFrameCount), static_cast<unsigned long long>(mMissedDeadlines),
+        getMeanDeadlineErrorMs(), mMaxDeadlineErrorMs);
+}
+
+/**
+ * Converts performance counter ticks to milliseconds.
+ * @param counter The number of ticks.
+ * @return The duration in milliseconds.
+ */
+double FrameScheduler::toMs(Uint64 counter) const {
+    return static_cast<double>(counter) * 1000.0 / static_cast<double>(mFrequency);
+}
+
+/**
+ * Converts milliseconds to performance counter ticks.
+ * @param ms The duration in milliseconds.
+ * @return The number of ticks.
+ */
+Uint64 FrameScheduler::fromMs(double ms) const {
+    return static_cast<Uint64>(ms * static_cast<double>(mFrequency) / 1000.0);
+}
@@ -0,0 +1,114 @@
+#include "FrameTimeHistogram.h"
+#include <algorithm>
+
+/**
+ * Constructor for the FrameTimeHistogram class.
+ * Starts with no samples.
+ */
+FrameTimeHistogram::FrameTimeHistogram() {
+    reset();
+}
+
+/**
+ * Adds one sample to the histogram.
+ * @param microseconds The duration to record; larger values than the range are clamped.
+ */
+void FrameTimeHistogram::record(Uint64 microseconds) {
+    Uint64 value = std::min<Uint64>(microseconds, (1ull << MAX_BITS) - 1);
+    ++mBuckets[getBucketIndex(value)];
+    ++mCount;
+    mSum += value;
+    mMax = std::max(mMax, value);
+}
+
+/**
+ * Removes all samples.
+ */
+void FrameTimeHistogram::reset() {
+    std::fill(mBuckets, mBuckets + BUCKET_COUNT, 0u);
+    mCount = 0;
+    mMax = 0;
+    mSum = 0;
+}
+
+/**
+ * Gets the number of recorded samples.
+ * @return The sample count.
+ */
+Uint64 FrameTimeHistogram::getCount() const {
+    return mCount;
+}
+
+/**
+ * Gets the largest recorded sample, exactly.
+ * @return The maximum in microseconds, or 0 if there are no samples.
+ */
+Uint64 FrameTimeHistogram::getMax() const {
+    return mMax;
+}
+
+/**
+ * Gets the average of the recorded samples, exactly.
+ * @return The mean in microseconds, or 0 if there are no samples.
+ */
+double FrameTimeHistogram::getMean() const {
+    return mCount == 0 ? 0.0 : static_cast<double>(mSum) / mCount;
+}
+
+/**
+ * Finds the value below or at which the given share of samples lie.
+ * @param percentile The share of samples in percent, in [0, 100].
+ * @return The upper bound of the bucket holding that sample in microseconds,
+ * never more than the maximum, or 0 if there are no samples.
+ */
+Uint64 FrameTimeHistogram::getPercentile(double percentile) const {
+    if (mCount == 0) {
+        return 0;
+    }
+
+    percentile = std::min(std::max(percentile, 0.0), 100.0);
+    Uint64 rank = static_cast<Uint64>(percentile / 100.0 * mCount + 0.5);
+    rank = std::max<Uint64>(rank, 1);
+
+    Uint64 seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += mBuckets[i];
+        if (seen >= rank) {
+            return std::min(getBucketUpperBound(i), mMax);
+        }
+    }
+    return mMax;
+}
+
+/**
+ * Maps a value to its bucket. Values below SUB_BUCKETS get a bucket each;
+ * above that, each power of two shares HALF_SUB_BUCKETS buckets.
+ * @param value The value, already clamped to the range.
+ * @return The bucket index.
+ */
+int FrameTimeHistogram::getBucketIndex(Uint64 value) {
+    if (value < SUB_BUCKETS) {
+        return static_cast<int>(value);
+    }
+
+    int highestBit = 0;
+    for (Uint64 v = value; v > 1; v >>= 1) {
+        ++highestBit;
+    }
+    int shift = highestBit - (SUB_BUCKET_BITS - 1);
+    return shift * HALF_SUB_BUCKETS + static_cast<int>(value >> shift);
+}
+
+/**
+ * Gets the largest value that maps to a bucket.
+ * @param index The bucket index.
+ * @return The upper bound in microseconds, inclusive.
+ */
+Uint64 FrameTimeHistogram::getBucketUpperBound(int index) {
+    if (index < SUB_BUCKETS) {
+        return static_cast<Uint64>(index);
+    }
+    int shift = index / HALF_SUB_BUCKETS - 1;
+    Uint64 subBucket = static_cast<Uint64>(index - shift * HALF_SUB_BUCKETS);
+    return ((subBucket + 1) << shift) - 1;
+}
@@ -0,0 +1,316 @@
+#include "IconAtlas.h"
+#include "AssetPackFormat.h"
+#include "Subsystems.h"
+#include <SDL_image.h>
+#include <stdio.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Returned for regions while no cell size has been set
+static const SDL_Rect EMPTY_RECT = { 0, 0, 0, 0 };
+
+/**
+ * Constructor for the IconAtlas class.
+ * @param renderer The custom Renderer used to create the atlas textures.
+ * @param assets The AssetCache that owns the atlas textures.
+ */
+IconAtlas::IconAtlas(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets)
+    : mRenderer(renderer), mAssets(assets), mCurrent(nullptr) {}
+
+/**
+ * Destructor for the IconAtlas class.
+ * The textures are released with the last handles to them.
+ */
+IconAtlas::~IconAtlas() {}
+
+/**
+ * Loads the icons, converts them to premultiplied alpha and builds a mip
+ * chain for each, so any cell size can later be resampled from a level at
+ * most twice as large.
+ * @param iconPaths A vector of file paths to the icons.
+ * @param loader An AssetLoader holding the icons queued with addSurface, or nullptr.
+ * @return True if at least one icon was loaded, false otherwise.
+ */
+bool IconAtlas::build(const std::vector<std::string>& iconPaths, AssetLoader* loader) {
+    mMipChains.clear();
+    mScaledSets.clear();
+    mCurrent = nullptr;
+
+    for (const auto& path : iconPaths) {
+        bool premultiplied = false;
+        SDL_Surface* surface = loader != nullptr ? loader->takeSurface(path, &premultiplied) : nullptr;
+        if (surface == nullptr && Subsystems::ensureImage()) {
+            surface = IMG_Load(path.c_str());
+        }
+        if (surface == nullptr) {
+            printf("Unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
+            continue;
+        }
+        if (!premultiplied) {
+            SDL_Surface* converted = SDL_ConvertSurfaceFormat(surface, SDL_PIXELFORMAT_ARGB8888, 0);
+            SDL_FreeSurface(surface);
+            if (converted == nullptr) {
+                printf("Unable to convert image %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
+                continue;
+            }
+            premultiplyAlpha(converted);
+            surface = converted;
+        }
+
+        Image source;
+        source.width = surface->w;
+        source.height = surface->h;
+        source.pixels.resize(static_cast<size_t>(surface->w) * surface->h);
+        for (int y = 0; y < surface->h; ++y) {
+            std::memcpy(&source.pixels[static_cast<size_t>(y) * surface->w],
+                static_cast<const Uint8*>(surface->pixels) + y * surface->pitch, surface->w * sizeof(Uint32));
+        }
+        SDL_FreeSurface(surface);
+
+        std::vector<Image> chain;
+        chain.push_back(source);
+        while (chain.back().width > 1 || chain.back().height > 1) {
+            chain.push_back(halveImage(chain.back()));
+        }
+        mMipChains.push_back(chain);
+    }
+    return !mMipChains.empty();
+}
+
+/**
+ * Selects the atlas for a cell size, building it on first use.
+ * @param width The width of the area an icon must fit in.
+ * @param height The height of the area an icon must fit in.
+ * @return True if the atlas for the size is available, false otherwise.
+ */
+bool IconAtlas::setCellSize(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+    auto key = std::make_pair(width, height);
+    auto it = mScaledSets.find(key);
+    if (it == mScaledSets.end()) {
+        ScaledSet set;
+        if (!createScaledSet(width, height, set)) {
+            return false;
+        }
+        it = mScaledSets.insert(std::make_pair(key, set)).first;
+    }
+    mCurrent = &it->second;
+    return true;
+}
+
+/**
+ * Resamples every icon to fit the cell while keeping its aspect ratio and
+ * packs the results side by side into a texture, followed by a small block
+ * of solid white texels.
+ * @param width The cell width.
+ * @param height The cell height.
+ * @param set The atlas to fill in.
+ * @return True if the texture was created, false otherwise.
+ */
+bool IconAtlas::createScaledSet(int width, int height, ScaledSet& set) {
+    std::vector<Image> icons;
+    int atlasWidth = PADDING;
+    int atlasHeight = SOLID_SIZE;
+    for (const std::vector<Image>& chain : mMipChains) {
+        const Image& source = chain.front();
+        double scale = std::min(static_cast<double>(width) / source.width, static_cast<double>(height) / source.height);
+        int iconWidth = std::max(1, std::min(width, static_cast<int>(std::lround(source.width * scale))));
+        int iconHeight = std::max(1, std::min(height, static_cast<int>(std::lround(source.height * scale))));
+
+        // Start from the smallest level that still covers the target
+        size_t level = 0;
+        while (level + 1 < chain.size() && chain[level + 1].width >= iconWidth && chain[level + 1].height >= iconHeight) {
+            ++level;
+        }
+        icons.push_back(resampleImage(chain[level], iconWidth, iconHeight));
+
+        set.iconRects.push_back({ atlasWidth, PADDING, iconWidth, iconHeight });
+        atlasWidth += iconWidth + PADDING;
+        atlasHeight = std::max(atlasHeight, iconHeight);
+    }
+    set.solidRect = { atlasWidth, PADDING, SOLID_SIZE, SOLID_SIZE };
+    atlasWidth += SOLID_SIZE + PADDING;
+    atlasHeight += 2 * PADDING;
+
+    bool success = false;
+    SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, atlasWidth, atlasHeight, 32, SDL_PIXELFORMAT_ARGB8888);
+    if (atlasSurface == nullptr) {
+        printf("Unable to create icon atlas surface! SDL Error: %s\n", SDL_GetError());
+        return false;
+    }
+
+    SDL_FillRect(atlasSurface, nullptr, 0);
+    for (size_t i = 0; i < icons.size(); ++i) {
+        const SDL_Rect& rect = set.iconRects[i];
+        for (int y = 0; y < rect.h; ++y) {
+            Uint8* row = static_cast<Uint8*>(atlasSurface->pixels) + (rect.y + y) * atlasSurface->pitch;
+            std::memcpy(row + rect.x * sizeof(Uint32), &icons[i].pixels[static_cast<size_t>(y) * rect.w], rect.w * sizeof(Uint32));
+        }
+    }
+
+    // Pad the solid block by one texel so linear filtering stays white at its edges
+    SDL_Rect solidFill = { set.solidRect.x - 1, set.solidRect.y - 1, set.solidRect.w + 2, set.solidRect.h + 2 };
+    SDL_FillRect(atlasSurface, &solidFill, SDL_MapRGBA(atlasSurface->format, 255, 255, 255, 255));
+
+    SDL_Texture* texture = mRenderer->createTexture(atlasSurface);
+    if (texture != nullptr) {
+        Renderer::setPremultipliedBlendMode(texture);
+        set.texture = mAssets->adoptTexture("atlas:icons@" + std::to_string(width) + "x" + std::to_string(height), texture);
+        success = true;
+    }
+    SDL_FreeSurface(atlasSurface);
+    return success;
+}
+
+/**
+ * Halves an image with a 2x2 box filter. An odd last row or column is
+ * averaged with itself.
+ * @param source The image to reduce.
+ * @return The next mip level.
+ */
+IconAtlas::Image IconAtlas::halveImage(const Image& source) {
+    Image result;
+    result.width = std::max(1, source.width / 2);
+    result.height = std::max(1, source.height / 2);
+    result.pixels.resize(static_cast<size_t>(result.width) * result.height);
+
+    for (int y = 0; y < result.height; ++y) {
+        int y0 = std::min(2 * y, source.height - 1);
+        int y1 = std::min(2 * y + 1, source.height - 1);
+        for (int x = 0; x < result.width; ++x) {
+            int x0 = std::min(2 * x, source.width - 1);
+            int x1 = std::min(2 * x + 1, source.width - 1);
+            Uint32 p[4] = {
+                source.pixels[static_cast<size_t>(y0) * source.width + x0],
+                source.pixels[static_cast<size_t>(y0) * source.width + x1],
+                source.pixels[static_cast<size_t>(y1) * source.width + x0],
+                source.pixels[static_cast<size_t>(y1) * source.width + x1]
+            };
+            Uint32 pixel = 0;
+            for (int shift = 0; shift < 32; shift += 8) {
+                Uint32 sum = 2; // Round to nearest
+                for (Uint32 q : p) {
+                    sum += (q >> shift) & 0xFF;
+                }
+                pixel |= (sum / 4) << shift;
+            }
+            result.pixels[static_cast<size_t>(y) * result.width + x] = pixel;
+        }
+    }
+    return result;
+}
+
+/**
+ * Resamples an image with an area filter: every output texel is the
+ * coverage-weighted average of the source texels under it. Used for
+ * reductions of less than 2x, after the mip chain did the rest.
+ * @param source The image to resample, premultiplied.
+ * @param width The output width.
+ * @param height The output height.
+ * @return The resampled image.
+ */
+IconAtlas::Image IconAtlas::resampleImage(const Image& source, int width, int height) {
+    struct Tap {
+        int index;
+        float weight;
+    };
+
+    // Source texels and their coverage for each output column or row
+    auto buildTaps = [](int sourceSize, int targetSize, std::vector<std::vector<Tap>>& taps) {
+        double step = static_cast<double>(sourceSize) / targetSize;
+        taps.assign(targetSize, std::vector<Tap>());
+        for (int i = 0; i < targetSize; ++i) {
+            double start = i * step;
+            double end = std::min(static_cast<double>(sourceSize), start + step);
+            for (int s = static_cast<int>(start); s < end; ++s) {
+                double coverage = std::min(end, s + 1.0) - std::max(start, static_cast<double>(s));
+                if (coverage > 0.0) {
+                    taps[i].push_back({ s, static_cast<float>(coverage / step) });
+                }
+            }
+        }
+    };
+
+    std::vector<std::vector<Tap>> columnTaps;
+    std::vector<std::vector<Tap>> rowTaps;
+    buildTaps(source.width, width, columnTaps);
+    buildTaps(source.height, height, rowTaps);
+
+    // Horizontal pass into floating point, then vertical pass back to 8 bits
+    std::vector<float> horizontal(static_cast<size_t>(width) * source.height * 4);
+    for (int y = 0; y < source.height; ++y) {
+        const Uint32* row = &source.pixels[static_cast<size_t>(y) * source.width];
+        float* out = &horizontal[static_cast<size_t>(y) * width * 4];
+        for (int x = 0; x < width; ++x) {
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (const Tap& tap : columnTaps[x]) {
+                Uint32 p = row[tap.index];
+                for (int c = 0; c < 4; ++c) {
+                    sum[c] += ((p >> (8 * c)) & 0xFF) * tap.weight;
+                }
+            }
+            std::memcpy(out + x * 4, sum, sizeof(sum));
+        }
+    }
+
+    Image result;
+    result.width = width;
+    result.height = height;
+    result.pixels.resize(static_cast<size_t>(width) * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (const Tap& tap : rowTaps[y]) {
+                const float* p = &horizontal[(static_cast<size_t>(tap.index) * width + x) * 4];
+                for (int c = 0; c < 4; ++c) {
+                    sum[c] += p[c] * tap.weight;
+                }
+            }
+            Uint32 pixel = 0;
+            for (int c = 0; c < 4; ++c) {
+                int value = static_cast<int>(sum[c] + 0.5f);
+                pixel |= static_cast<Uint32>(std::min(255, std::max(0, value))) << (8 * c);
+            }
+            result.pixels[static_cast<size_t>(y) * width + x] = pixel;
+        }
+    }
+    return result;
+}
+
+/**
+ * Gets the atlas texture for the current cell size.
+ * @return The texture, or nullptr if no cell size has been set.
+ */
+SDL_Texture* IconAtlas::getTexture() const {
+    return mCurrent != nullptr ? mCurrent->texture.get() : nullptr;
+}
+
+/**
+ * Gets the number of icons in the atlas.
+ * @return The icon count.
+ */
+int IconAtlas::getIconCount() const {
+    return static_cast<int>(mMipChains.size());
+}
+
+/**
+ * Gets the region of an icon in the atlas texture for the current cell size.
+ * @param index The index of the icon.
+ * @return The source rectangle of the icon, already at its on-screen size,
+ *         or an empty rectangle if no cell size has been set.
+ */
+const SDL_Rect& IconAtlas::getIconRect(int index) const {
+    return mCurrent != nullptr ? mCurrent->iconRects[index] : EMPTY_RECT;
+}
+
+/**
+ * Gets a region of opaque white texels for solid colored quads.
+ * @return The source rectangle of the solid block, or an empty rectangle
+ *         if no cell size has been set.
+ */
+const SDL_Rect& IconAtlas::getSolidRect() const {
+    return mCurrent != nullptr ? mCurrent->solidRect : EMPTY_RECT;
+}
@@ -1,8 +1,9 @@
 #include "LTexture.h"
+#include "Subsystems.h"
 #include <SDL_ttf.h>
 #include <stdio.h>
 
-LTexture::LTexture(SDL_Renderer* renderer)
+LTexture::LTexture(std::shared_ptr<Renderer> renderer)
     : mRenderer(renderer), mTexture(nullptr), mWidth(0), mHeight(0) {}
 
 LTexture::~LTexture() {
@@ -11,14 +12,14 @@ LTexture::~LTexture() {
 
 bool LTexture::loadFromFile(const std::string& path) {
     free();
-    SDL_Surface* loadedSurface = IMG_Load(path.c_str());
+    SDL_Surface* loadedSurface = Subsystems::ensureImage() ? IMG_Load(path.c_str()) : nullptr;
     if (loadedSurface == nullptr) {
         printf("Unable to load image %s! SDL_image Error: %s\n", path.c_str(), IMG_GetError());
         return false;
     }
-    mTexture = SDL_CreateTextureFromSurface(mRenderer, loadedSurface);
+    mTexture = mRenderer->createTexture(loadedSurface);
     if (mTexture == nullptr) {
-        printf("Unable to create texture from %s! SDL Error: %s\n", path.c_str(), SDL_GetError());
+        printf("Unable to create texture from %s!\n", path.c_str());
         SDL_FreeSurface(loadedSurface);
         return false;
     }
@@ -35,9 +36,9 @@ bool LTexture::loadFromRenderedText(const std::string& textureText, SDL_Color te
         printf("Unable to render text surface! SDL_ttf Error: %s\n", TTF_GetError());
         return false;
     }
-    mTexture = SDL_CreateTextureFromSurface(mRenderer, textSurface);
+    mTexture = mRenderer->createTexture(textSurface);
     if (mTexture == nullptr) {
-        printf("Unable to create texture from rendered text! SDL Error: %s\n", SDL_GetError());
+        printf("Unable to create texture from rendered text!\n");
         SDL_FreeSurface(textSurface);
         return false;
     }
@@ -58,13 +59,13 @@ void LTexture::free() {
 
 void LTexture::render(int x, int y) {
     SDL_Rect renderQuad = { x, y, mWidth, mHeight };
-    SDL_RenderCopy(mRenderer, mTexture, nullptr, &renderQuad);
+    mRenderer->renderTexture(mTexture, nullptr, &renderQuad);
 }
 
-int LTexture::getWidth() {
+int LTexture::getWidth() const {
     return mWidth;
 }
 
-int LTexture::getHeight() {
+int LTexture::getHeight() const {
     return mHeight;
 }
@@ -1,55 +1,59 @@
 #include "LTimer.h"
 
-LTimer::LTimer()
-    : mStartTicks(0), mPausedTicks(0), mPaused(false), mStarted(false) {}
+LTimer::LTimer(const FrameClock& clock)
+    : mClock(&clock), mStartMs(0.0), mPausedMs(0.0), mPaused(false), mStarted(false) {}
 
 void LTimer::start() {
     mStarted = true;
     mPaused = false;
-    mStartTicks = SDL_GetTicks();
-    mPausedTicks = 0;
+    mStartMs = mClock->getMs();
+    mPausedMs = 0.0;
 }
 
 void LTimer::stop() {
     mStarted = false;
     mPaused = false;
-    mStartTicks = 0;
-    mPausedTicks = 0;
+    mStartMs = 0.0;
+    mPausedMs = 0.0;
 }
 
 void LTimer::pause() {
     if (mStarted && !mPaused) {
         mPaused = true;
-        mPausedTicks = SDL_GetTicks() - mStartTicks;
-        mStartTicks = 0;
+        mPausedMs = mClock->getMs() - mStartMs;
+        mStartMs = 0.0;
     }
 }
 
 void LTimer::unpause() {
     if (mStarted && mPaused) {
         mPaused = false;
-        mStartTicks = SDL_GetTicks() - mPausedTicks;
-        mPausedTicks = 0;
+        mStartMs = mClock->getMs() - mPausedMs;
+        mPausedMs = 0.0;
     }
 }
 
-Uint32 LTimer::getTicks() {
-    Uint32 time = 0;
+Uint32 LTimer::getTicks() const {
+    return static_cast<Uint32>(getMs());
+}
+
+double LTimer::getMs() const {
+    double time = 0.0;
     if (mStarted) {
         if (mPaused) {
-            time = mPausedTicks;
+            time = mPausedMs;
         }
         else {
-            time = SDL_GetTicks() - mStartTicks;
+            time = mClock->getMs() - mStartMs;
         }
     }
     return time;
 }
 
-bool LTimer::isStarted() {
+bool LTimer::isStarted() const {
     return mStarted;
 }
 
-bool LTimer::isPaused() {
+bool LTimer::isPaused() const {
     return mPaused && mStarted;
 }
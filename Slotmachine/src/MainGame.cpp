@@ -2,15 +2,16 @@
 #include <SDL_image.h>
 #include <SDL_ttf.h>
 #include <SDL_mixer.h>
-#include <ctime>
+#include <algorithm>
 
 /**
  * MainGame class constructor.
- * Initializes member variables and seeds the random number generator.
+ * Initializes member variables.
  */
 MainGame::MainGame()
-    : gWindow(nullptr), backgroundMusic(nullptr), lastTime(0), currentTime(0), deltaTime(0), areReelsSpinning(false) {
-    std::srand(static_cast<unsigned>(std::time(0))); // Initialize random seed
+    : backgroundMusic(nullptr), scheduler(0.0, TARGET_FRAME_RATE), vsyncEnabled(USE_VSYNC),
+    pendingSpin(0), randomSeed(Random::makeSeed()), outcomeRandom(0), pendingResult{}, areReelsSpinning(false) {
+    scheduler.setVSync(vsyncEnabled);
 }
 
 /**
@@ -22,49 +23,25 @@ MainGame::~MainGame() {
 }
 
 /**
- * Initializes SDL, creates the window and renderer, and initializes SDL_ttf and SDL_mixer.
+ * Creates the window and renderer. The other SDL libraries are started
+ * lazily by Subsystems when the first asset that needs them is loaded.
  * @return True if initialization is successful, false otherwise.
  */
 bool MainGame::init() {
-    bool success = true;
+    Uint64 start = SDL_GetPerformanceCounter();
 
-    if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO) < 0) {
-        printf("SDL could not initialize! SDL_Error: %s\n", SDL_GetError());
-        success = false;
+    gRenderer = std::make_shared<Renderer>(SCREEN_WIDTH, SCREEN_HEIGHT);  // Create Renderer instance
+    if (!gRenderer->init("Slot Machine")) {
+        printf("Renderer could not be initialized!\n");
+        return false;
     }
-    else {
-        gWindow = SDL_CreateWindow("Slot Machine", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, SCREEN_WIDTH, SCREEN_HEIGHT, SDL_WINDOW_SHOWN);
-        if (gWindow == nullptr) {
-            printf("Window could not be created! SDL_Error: %s\n", SDL_GetError());
-            success = false;
-        }
-        else {
-            gRenderer = std::make_shared<Renderer>(SCREEN_WIDTH, SCREEN_HEIGHT);  // Create Renderer instance
-            if (!gRenderer->init("Slot Machine")) {
-                printf("Renderer could not be initialized!\n");
-                success = false;
-            }
-            else {
-                // Initialize SDL_ttf
-                if (TTF_Init() == -1) {
-                    printf("SDL_ttf could not initialize! SDL_ttf Error: %s\n", TTF_GetError());
-                    success = false;
-                }
-
-                // Initialize SDL_mixer
-                if (Mix_Init(MIX_INIT_MP3) == 0) {
-                    printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
-                    success = false;
-                }
-                if (Mix_OpenAudio(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, 4096) != 0) {
-                    printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
-                    success = false;
-                }
-            }
-        }
+    if (vsyncEnabled && !gRenderer->setVSync(true)) {
+        vsyncEnabled = false;
+        scheduler.setVSync(false); // Fall back to timed pacing
     }
 
-    return success;
+    Subsystems::addPhase("window + renderer", start);
+    return true;
 }
 
 /**
@@ -72,13 +49,38 @@ bool MainGame::init() {
  * @return True if all media assets are loaded successfully, false otherwise.
  */
 bool MainGame::loadMedia() {
-    background = std::make_unique<Background>(gRenderer);
+    Uint64 start = SDL_GetPerformanceCounter();
+    assets = std::make_shared<AssetCache>(gRenderer);
+
+    // Decode images and sounds in parallel up front; the objects below then find them in the cache
+    std::vector<std::string> iconPaths = { "assets/icons/watermelon.png", "assets/icons/apple.png", "assets/icons/cherries.png" };
+    AssetLoader loader(gRenderer, assets);
+    assetPack = std::make_shared<AssetPack>();
+    if (assetPack->open("assets/assets.pack")) {
+        loader.setPack(assetPack);
+    }
+    else {
+        printf("No asset pack, decoding loose files\n");
+        assetPack.reset();
+    }
+    loader.addTexture("assets/textures/background.jpeg");
+    loader.addTexture("assets/textures/bottom.jpg");
+    loader.addTexture("assets/textures/top.jpg");
+    loader.addSound("assets/sounds/click2.mp3");
+    for (const auto& path : iconPaths) {
+        loader.addSurface(path);
+    }
+    if (!loader.load([this](int completed, int total) { drawSplash(completed, total); })) {
+        printf("Some assets failed to load!\n");
+    }
+
+    background = std::make_unique<Background>(gRenderer, assets);
     if (!background->loadMedia("assets/textures/background.jpeg")) {
         printf("Failed to load media!\n");
         return false;
     }
 
-    frame = std::make_unique<Frame>(gRenderer);
+    frame = std::make_unique<Frame>(gRenderer, assets);
     frame->setDimensions(500, 300); // Adjust dimensions if needed
 
     // Load texture for the bottom section
@@ -91,34 +93,83 @@ bool MainGame::loadMedia() {
         printf("Failed to load bottom texture!\n");
     }
 
+    // Background and frame never change, so they are composited once
+    staticLayer = std::make_unique<StaticLayer>(gRenderer, assets, SCREEN_WIDTH, SCREEN_HEIGHT);
+
     // Load font for FPSMeter
-    TTF_Font* font = TTF_OpenFont("assets/fonts/arial.ttf", 28);
-    if (font == nullptr) {
-        printf("Failed to load font! SDL_ttf Error: %s\n", TTF_GetError());
+    fpsFont = assets->getFont("assets/fonts/arial.ttf", 28);
+    overlayFont = assets->getFont("assets/fonts/arial.ttf", 14);
+    if (!fpsFont || !overlayFont) {
+        printf("Failed to load font!\n");
         return false;
     }
     else {
-        fpsMeter = std::make_unique<FPSMeter>(gRenderer, font);
-        fpsMeter->start();
+        fpsMeter = std::make_unique<FPSMeter>(gRenderer, fpsFont.get(), overlayFont.get());
+        frameClock.tick();
+        fpsMeter->start(frameClock);
     }
 
     // Create and load button using the custom Renderer class
-    button = std::make_unique<Button>(gRenderer, SCREEN_WIDTH / 2 + 115, SCREEN_HEIGHT - 128, 100, 50, "START");
+    textRenderer = std::make_shared<TextRenderer>(gRenderer, assets);
+    button = std::make_unique<Button>(gRenderer, textRenderer, assets, SCREEN_WIDTH / 2 + 115, SCREEN_HEIGHT - 128, 100, 50, "START");
 
     // Create reels and add them to the MainGame
-    std::vector<std::string> iconPaths = { "assets/icons/watermelon.png", "assets/icons/apple.png", "assets/icons/cherries.png" };
+    iconAtlas = std::make_shared<IconAtlas>(gRenderer, assets);
+    if (!iconAtlas->build(iconPaths, &loader)) {
+        printf("Failed to build icon atlas!\n");
+        return false;
+    }
 
+    // The outcome engine owns the game math; its symbols are indices into iconPaths
+    const MachineConfig machine = MachineConfig::createClassic();
+    if (!machine.isValid()) {
+        printf("Invalid machine configuration!\n");
+        return false;
+    }
+    for (const auto& strip : machine.strips) {
+        for (int symbol : strip) {
+            if (symbol >= iconAtlas->getIconCount()) {
+                printf("Machine uses symbol %d but only %d icons are loaded!\n", symbol, iconAtlas->getIconCount());
+                return false;
+            }
+        }
+    }
+    outcomeEngine = std::make_unique<OutcomeEngine>(machine);
+
+    int reelCount = outcomeEngine->getReelCount();
     int frameWidth = frame->getWidth();
     int frameHeight = frame->getHeight();
-    int reelWidth = frameWidth / 5;
+    int reelWidth = frameWidth / reelCount;
     int reelHeight = frameHeight;
 
-    for (int i = 0; i < 5; ++i) {
-        auto reel = std::make_unique<Reel>(gRenderer, frame->getX() + i * reelWidth, frame->getY(), reelWidth, reelHeight, iconPaths);
+    for (int i = 0; i < reelCount; ++i) {
+        auto reel = std::make_unique<Reel>(gRenderer, iconAtlas, frame->getX() + i * reelWidth, frame->getY(), reelWidth, reelHeight);
+        reel->setStrip(machine.strips[i], machine.rows);
         mReels.push_back(std::move(reel));
     }
 
+    // The simulation mirrors the reels; its snapshots drive Reel::setState
+    printf("Random seed: %llu\n", static_cast<unsigned long long>(randomSeed));
+    simulation = std::make_unique<Simulation>(SIMULATION_STEP_MS, randomSeed);
+    for (int i = 0; i < reelCount; ++i) {
+        simulation->addReel(mReels[i]->getStripHeight(), outcomeEngine->getStripLength(i));
+    }
+
+    // Far enough along the sequence that it never overlaps the simulation's streams
+    outcomeRandom.seed(randomSeed);
+    outcomeRandom.longJump();
+
+    if (!bakeReelStrips()) {
+        printf("Failed to render reel strips!\n");
+        return false;
+    }
+
+    assets->printReport();
+
     // Load and play background music
+    if (!Subsystems::ensureAudio()) {
+        return false;
+    }
     backgroundMusic = Mix_LoadMUS("assets/sounds/jazz.mp3"); // Replace with your music file path
     if (backgroundMusic == nullptr) {
         printf("Failed to load background music! SDL_mixer Error: %s\n", Mix_GetError());
@@ -129,93 +180,297 @@ bool MainGame::loadMedia() {
         return false;
     }
 
+    Subsystems::addPhase("load media", start);
+    Subsystems::printStartupReport();
     return true;
 }
 
+/**
+ * Draws a loading progress bar straight to the window while media is loading.
+ * @param completed The number of files loaded so far.
+ * @param total The total number of files.
+ */
+void MainGame::drawSplash(int completed, int total) {
+    SDL_PumpEvents(); // Keep the window responsive while loading
+
+    gRenderer->clearScreen(0, 0, 0, 255);
+    SDL_Rect track = { SCREEN_WIDTH / 4, SCREEN_HEIGHT / 2 - 10, SCREEN_WIDTH / 2, 20 };
+    gRenderer->setDrawColor(64, 64, 64, 255);
+    gRenderer->fillRect(track);
+
+    SDL_Rect bar = track;
+    bar.w = total > 0 ? track.w * completed / total : track.w;
+    gRenderer->setDrawColor(255, 215, 0, 255);
+    gRenderer->fillRect(bar);
+    gRenderer->present();
+}
+
 /**
  * Handles user input events such as quitting the game or pressing keys.
  * @param quit Reference to a boolean that indicates whether the game should quit.
  */
 void MainGame::handleEvents(bool& quit) {
+    PROFILE_ZONE("MainGame::handleEvents");
     SDL_Event e;
     while (SDL_PollEvent(&e) != 0) {
-        if (e.type == SDL_QUIT) {
+        handleEvent(e, quit);
+    }
+}
+
+/**
+ * Handles a single user input or window event.
+ * @param e The SDL_Event to handle.
+ * @param quit Reference to a boolean that indicates whether the game should quit.
+ */
+void MainGame::handleEvent(const SDL_Event& e, bool& quit) {
+    if (e.type == SDL_QUIT) {
+        quit = true;
+    }
+    else if (e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET) {
+        bakeReelStrips(); // Render target contents were lost
+        staticLayer->invalidate();
+        gRenderer->invalidateAll();
+    }
+    else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+        staticLayer->invalidate();
+    }
+    else if (e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_EXPOSED) {
+        gRenderer->invalidateAll();
+    }
+    else if (e.type == SDL_KEYDOWN) {
+        if (e.key.keysym.sym == SDLK_ESCAPE) {
             quit = true;
         }
-        else if (e.type == SDL_KEYDOWN) {
-            if (e.key.keysym.sym == SDLK_ESCAPE) {
-                quit = true;
-            }
+        else if (e.key.keysym.sym == SDLK_F3 && fpsMeter) {
+            fpsMeter->setDetailsVisible(!fpsMeter->isDetailsVisible());
+        }
+        else if (e.key.keysym.sym == SDLK_F8) {
+            Profiler::setEnabled(!Profiler::isEnabled());
+            printf("Profiler %s\n", Profiler::isEnabled() ? "enabled" : "disabled");
         }
+        else if (e.key.keysym.sym == SDLK_F9) {
+            Profiler::writeChromeTrace(PROFILE_TRACE_PATH);
+        }
+    }
 
-        button->handleEvent(e);
+    button->handleEvent(e);
 
-        if (button->isClicked() && !areReelsSpinning) {
-            Uint32 startTime = SDL_GetTicks();
-            Uint32 stopDelay = 0;
-            for (auto& reel : mReels) {
-                reel->startSpin(0, stopDelay);
-                stopDelay += 500;
-            }
-            areReelsSpinning = true;
-            button->setActive(false);
-            button->resetClick();
-        }
+    if (button->isClicked() && !areReelsSpinning) {
+        // The result is final before the reels move; they only animate toward it
+        outcomeEngine->spin(outcomeRandom, pendingResult);
+        pendingSpin = simulation->requestSpin(pendingResult.stops, pendingResult.reelCount);
+        areReelsSpinning = true;
+        button->setActive(false);
+        button->resetClick();
     }
 }
 
+/**
+ * Checks if nothing on screen will change until the next scheduled animation:
+ * the reels are stopped and no region is waiting to be repainted. A static
+ * layer that could not be created is drawn directly and does not stay dirty.
+ * @return True if the game is idle, false otherwise.
+ */
+bool MainGame::isIdle() const {
+    return !areReelsSpinning && !staticLayer->isDirty() && !gRenderer->hasDirtyRegions();
+}
+
+/**
+ * Blocks until an event arrives or the next scheduled visual change is due,
+ * and handles the event if there is one.
+ * @param quit Reference to a boolean that indicates whether the game should quit.
+ */
+void MainGame::waitForEvents(bool& quit) {
+    frameClock.tick(); // Measure the timeouts from the start of the wait
+    Uint32 timeout = button->getMsUntilNextChange(frameClock);
+    if (fpsMeter) {
+        timeout = std::min(timeout, fpsMeter->getMsUntilNextUpdate(frameClock));
+    }
+    if (timeout == 0) {
+        return;
+    }
+
+    SDL_Event e;
+    int waitMs = timeout == SDL_MAX_UINT32 ? -1 : static_cast<int>(timeout);
+    if (SDL_WaitEventTimeout(&e, waitMs) != 0) {
+        handleEvent(e, quit);
+    }
+}
+
+/**
+ * Sets how the main loop paces frames. Call before init.
+ * @param targetFrameRate The frame rate to pace to when vsync does not, or 0 for unlimited.
+ * @param vsync True to synchronize presents to the display refresh.
+ */
+void MainGame::setFramePacing(int targetFrameRate, bool vsync) {
+    vsyncEnabled = vsync;
+    scheduler.setTargetFrameRate(targetFrameRate);
+    scheduler.setVSync(vsync);
+}
+
+/**
+ * Sets the seed the spins are drawn from, so a session can be replayed.
+ * Call before loadMedia; by default every run gets a fresh seed.
+ * @param seed The random seed.
+ */
+void MainGame::setRandomSeed(uint64_t seed) {
+    randomSeed = seed;
+}
+
 /**
  * Renders the game objects to the screen.
+ * Only the regions invalidated since the last frame are repainted; if nothing
+ * changed, the frame is skipped without presenting.
+ * @return True if a frame was presented, false if it was skipped.
  */
-void MainGame::render() {
-    gRenderer->clearScreen(255, 255, 255, 255);  // Clear screen using the Renderer class
+bool MainGame::render() {
+    PROFILE_ZONE("MainGame::render");
+    // Recompositing the static layer invalidates the whole screen
+    bool cached = staticLayer->composite([this]() {
+        background->render();
+        frame->render();
+    });
+
+    if (!gRenderer->beginFrame()) {
+        return false;
+    }
 
-    background->render();
-    frame->render();
-    for (auto& reel : mReels) {
-        reel->render(deltaTime);
+    for (const SDL_Rect& region : gRenderer->getDirtyRegions()) {
+        gRenderer->setClipRect(&region);
+
+        // The static layer covers the whole screen, so no clear is needed
+        if (cached) {
+            staticLayer->render(region);
+        }
+        else {
+            // A clear ignores the clip rect, so only the region is filled
+            gRenderer->setDrawColor(255, 255, 255, 255);
+            gRenderer->fillRect(region);
+            background->render();
+            frame->render();
+        }
+
+        // All reels go out as one geometry batch on the shared strip texture
+        gRenderer->beginBatch(reelStrips.get());
+        for (auto& reel : mReels) {
+            reel->render(region); // Emits nothing outside the region
+        }
+        gRenderer->flushBatch();
+
+        if (SDL_HasIntersection(&button->getRect(), &region)) {
+            button->render();
+        }
+        if (fpsMeter) {
+            fpsMeter->render(10, SCREEN_HEIGHT - 30);
+        }
     }
-    button->render();
-    if (fpsMeter) {
-        fpsMeter->update();
-        fpsMeter->render(10, SCREEN_HEIGHT - 30);
+
+    gRenderer->endFrame();  // Present the screen using the Renderer class
+    return true;
+}
+
+/**
+ * Renders every reel's symbol strip into one shared render-target texture,
+ * with the reels laid out side by side. Creates the texture on first use.
+ * @return True if the strips were rendered, false otherwise.
+ */
+bool MainGame::bakeReelStrips() {
+    // Icons are resampled once for the reel cell size; sizes already built are cached
+    if (mReels.empty()) {
+        return false;
+    }
+    SDL_Point cell = mReels.front()->getIconCellSize();
+    if (!iconAtlas->setCellSize(cell.x, cell.y)) {
+        return false;
     }
 
-    gRenderer->present();  // Present the screen using the Renderer class
+    if (!reelStrips) {
+        int width = 0;
+        int height = 0;
+        for (auto& reel : mReels) {
+            width += reel->getRect().w;
+            height = std::max(height, reel->getStripHeight());
+        }
+        SDL_Texture* texture = gRenderer->createTargetTexture(std::max(width, 1), std::max(height, 1));
+        if (texture == nullptr) {
+            return false;
+        }
+        gRenderer->setTextureBlendMode(texture, SDL_BLENDMODE_NONE); // Strips are opaque
+        reelStrips = assets->adoptTexture("target:reel-strips", texture);
+    }
+
+    int stripX = 0;
+    for (auto& reel : mReels) {
+        reel->bakeStrip(reelStrips.get(), stripX);
+        stripX += reel->getRect().w;
+    }
+    return true;
 }
 
 /**
  * Main game loop that handles events, updates game state, and renders the game.
+ * Reels are simulated in fixed steps on the simulation thread; this loop renders
+ * the latest snapshot interpolated between its last two steps, and the scheduler
+ * sleeps away the rest of each frame's budget. While idle, the loop blocks on
+ * the event queue until the next visual change. The frame clock is sampled
+ * once per frame and every time-based update in the frame reads that sample.
  */
 void MainGame::run() {
     bool quit = false;
+    Profiler::setThreadName("main");
+    if (!simulation->start()) {
+        return;
+    }
+    scheduler.reset();
 
     while (!quit) {
-        Uint32 newTime = SDL_GetTicks();
-        deltaTime = newTime - lastTime;
-        lastTime = newTime;
+        // Between spins, sleep in the event queue instead of polling
+        if (isIdle()) {
+            waitForEvents(quit);
+            scheduler.reset();
+            if (fpsMeter) {
+                fpsMeter->resume(); // The wait is not a slow frame
+            }
+        }
+
+        PROFILE_ZONE("MainGame::frame");
+        frameClock.tick();
+        scheduler.beginFrame(frameClock.getCounter());
 
         handleEvents(quit);
 
-        for (auto& reel : mReels) {
-            reel->update(deltaTime);
+        // Never blocks: the snapshot is whatever the simulation published last
+        const GameSnapshot& snapshot = simulation->acquireSnapshot();
+        float alpha = simulation->getInterpolation(snapshot, frameClock.getCounter());
+        int reelCount = std::min(snapshot.reelCount, static_cast<int>(mReels.size()));
+        for (int i = 0; i < reelCount; ++i) {
+            mReels[i]->setState(snapshot.reels[i], alpha);
         }
 
-        if (areReelsSpinning) {
-            bool allStopped = true;
-            for (auto& reel : mReels) {
-                if (reel->isSpinning()) {
-                    allStopped = false;
-                    break;
-                }
-            }
-            if (allStopped) {
-                areReelsSpinning = false;
-                button->setActive(true);
-            }
+        // The spin is over once the simulation has started it and all reels stopped
+        if (areReelsSpinning && snapshot.spinCount >= pendingSpin && !snapshot.spinning) {
+            areReelsSpinning = false;
+            button->setActive(true);
+            printf("Spin won %u line bets on %d lines\n", pendingResult.totalWin, pendingResult.winCount);
         }
 
-        render();
+        button->update(frameClock);
+        if (fpsMeter) {
+            fpsMeter->update(frameClock);
+        }
+
+        bool presented = render();
+        scheduler.endFrame(presented);
+    }
+
+    simulation->stop();
+    scheduler.printStats();
+    if (fpsMeter) {
+        fpsMeter->printStats();
+    }
+
+    if (Profiler::isEnabled()) {
+        Profiler::writeChromeTrace(PROFILE_TRACE_PATH);
     }
 }
 
@@ -231,8 +486,22 @@ void MainGame::close() {
         backgroundMusic = nullptr;
     }
 
-    SDL_DestroyWindow(gWindow);
-    Mix_Quit(); // Quit SDL_mixer
-    TTF_Quit();
-    SDL_Quit();
+    // Release every cached asset before the subsystems shut down
+    simulation.reset();
+    mReels.clear();
+    reelStrips.reset();
+    iconAtlas.reset();
+    button.reset();
+    textRenderer.reset();
+    fpsMeter.reset();
+    fpsFont.reset();
+    overlayFont.reset();
+    staticLayer.reset();
+    frame.reset();
+    background.reset();
+    assets.reset();
+    assetPack.reset();
+    gRenderer.reset(); // Destroys the window
+
+    Subsystems::shutdown();
 }
@@ -0,0 +1,134 @@
+#include "MappedFile.h"
+#include <stdio.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Constructor for the MappedFile class.
+ */
+#ifdef _WIN32
+MappedFile::MappedFile()
+    : mData(nullptr), mSize(0), mFile(INVALID_HANDLE_VALUE), mMapping(nullptr) {}
+#else
+MappedFile::MappedFile()
+    : mData(nullptr), mSize(0), mFile(-1) {}
+#endif
+
+/**
+ * Destructor for the MappedFile class.
+ * Unmaps the file if it is open.
+ */
+MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * Maps a whole file into memory for reading.
+ * @param path The file path.
+ * @return True if the file was mapped, false otherwise.
+ */
+bool MappedFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    mFile = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (mFile == INVALID_HANDLE_VALUE) {
+        printf("Unable to open %s! Windows error: %lu\n", path.c_str(), GetLastError());
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0) {
+        printf("Unable to map empty file %s!\n", path.c_str());
+        close();
+        return false;
+    }
+    mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mMapping == nullptr) {
+        printf("Unable to map %s! Windows error: %lu\n", path.c_str(), GetLastError());
+        close();
+        return false;
+    }
+    mData = static_cast<const Uint8*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+    if (mData == nullptr) {
+        printf("Unable to map %s! Windows error: %lu\n", path.c_str(), GetLastError());
+        close();
+        return false;
+    }
+    mSize = static_cast<size_t>(size.QuadPart);
+#else
+    mFile = ::open(path.c_str(), O_RDONLY);
+    if (mFile < 0) {
+        printf("Unable to open %s!\n", path.c_str());
+        return false;
+    }
+    struct stat info;
+    if (fstat(mFile, &info) != 0 || info.st_size == 0) {
+        printf("Unable to map empty file %s!\n", path.c_str());
+        close();
+        return false;
+    }
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, mFile, 0);
+    if (data == MAP_FAILED) {
+        printf("Unable to map %s!\n", path.c_str());
+        close();
+        return false;
+    }
+    mData = static_cast<const Uint8*>(data);
+    mSize = static_cast<size_t>(info.st_size);
+#endif
+    return true;
+}
+
+/**
+ * Unmaps the file. Pointers returned by getData become invalid.
+ */
+void MappedFile::close() {
+#ifdef _WIN32
+    if (mData != nullptr) {
+        UnmapViewOfFile(mData);
+    }
+    if (mMapping != nullptr) {
+        CloseHandle(mMapping);
+        mMapping = nullptr;
+    }
+    if (mFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(mFile);
+        mFile = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (mData != nullptr) {
+        munmap(const_cast<Uint8*>(mData), mSize);
+    }
+    if (mFile >= 0) {
+        ::close(mFile);
+        mFile = -1;
+    }
+#endif
+    mData = nullptr;
+    mSize = 0;
+}
+
+/**
+ * Gets the mapped contents of the file.
+ * @return A pointer to the first byte, or nullptr if no file is mapped.
+ */
+const Uint8* MappedFile::getData() const {
+    return mData;
+}
+
+/**
+ * Gets the size of the mapped file.
+ * @return The size in bytes.
+ */
+size_t MappedFile::getSize() const {
+    return mSize;
+}
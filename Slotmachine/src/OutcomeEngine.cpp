@@ -0,0 +1,289 @@
+#include "OutcomeEngine.h"
+#include <stdio.h>
+#include <cstring>
+
+static_assert(static_cast<int>(MachineConfig::MAX_REELS) <= static_cast<int>(WindowBatch::MAX_REELS), "Window batch too small for the machine limits");
+static_assert(static_cast<int>(MachineConfig::MAX_ROWS) <= static_cast<int>(WindowBatch::MAX_ROWS), "Window batch too small for the machine limits");
+static_assert(static_cast<int>(MachineConfig::MAX_PAYLINES) <= static_cast<int>(LineScores::MAX_LINES), "Line scores too small for the machine limits");
+static_assert(static_cast<int>(MachineConfig::MAX_SYMBOLS) <= static_cast<int>(LineCounts::MAX_SYMBOLS), "Line counts too small for the machine limits");
+static_assert(static_cast<int>(MachineConfig::MAX_REELS) <= static_cast<int>(LineCounts::MAX_REELS), "Line counts too small for the machine limits");
+
+/**
+ * Checks that the machine fits the engine's limits and is self-consistent.
+ * Prints the first problem found.
+ * @return True if the configuration can be used, false otherwise.
+ */
+bool MachineConfig::isValid() const {
+    if (strips.empty() || strips.size() > MAX_REELS) {
+        printf("Machine must have between 1 and %d reels!\n", static_cast<int>(MAX_REELS));
+        return false;
+    }
+    if (rows < 1 || rows > MAX_ROWS) {
+        printf("Machine must show between 1 and %d rows!\n", static_cast<int>(MAX_ROWS));
+        return false;
+    }
+    if (paylines.size() > MAX_PAYLINES) {
+        printf("Machine cannot have more than %d paylines!\n", static_cast<int>(MAX_PAYLINES));
+        return false;
+    }
+    if (pays.size() > MAX_SYMBOLS) {
+        printf("Machine cannot have more than %d symbols!\n", static_cast<int>(MAX_SYMBOLS));
+        return false;
+    }
+    for (const std::vector<int>& strip : strips) {
+        if (static_cast<int>(strip.size()) < rows) {
+            printf("Reel strips must be at least as long as the window!\n");
+            return false;
+        }
+        for (int symbol : strip) {
+            if (symbol < 0 || symbol >= static_cast<int>(pays.size())) {
+                printf("Reel strip symbol %d has no paytable entry!\n", symbol);
+                return false;
+            }
+        }
+    }
+    for (const std::vector<int>& line : paylines) {
+        if (line.size() != strips.size()) {
+            printf("Paylines must give one row per reel!\n");
+            return false;
+        }
+        for (int row : line) {
+            if (row < 0 || row >= rows) {
+                printf("Payline row %d is outside the window!\n", row);
+                return false;
+            }
+        }
+    }
+    for (const std::vector<uint32_t>& symbolPays : pays) {
+        if (symbolPays.size() > strips.size() + 1) {
+            printf("Paytable has wins for more symbols than there are reels!\n");
+            return false;
+        }
+        for (uint32_t pay : symbolPays) {
+            if (pay > static_cast<uint32_t>(MAX_PAY)) {
+                printf("Pay %u is too large!\n", pay);
+                return false;
+            }
+        }
+    }
+    if (wild < -1 || wild >= static_cast<int>(pays.size())) {
+        printf("Wild symbol %d has no paytable entry!\n", wild);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Creates the machine the game ships with. Symbol 0 is the watermelon,
+ * 1 the apple and 2 the cherries, matching the icon order in MainGame.
+ * Lines pay left to right; the return to player is about 94.1%.
+ * @return The machine configuration.
+ */
+MachineConfig MachineConfig::createClassic() {
+    MachineConfig config;
+    config.rows = 3;
+    config.strips = {
+        { 2, 1, 2, 0, 2, 1, 2, 2, 1, 2, 0, 1 },
+        { 2, 1, 0, 2, 1, 2, 2, 1, 2, 0, 2, 1 },
+        { 1, 2, 2, 0, 1, 2, 1, 2, 0, 2, 2, 1 },
+        { 2, 0, 1, 2, 2, 1, 2, 0, 1, 2, 1, 2 },
+        { 1, 2, 0, 2, 1, 2, 2, 1, 0, 2, 1, 2 }
+    };
+    config.paylines = {
+        { 1, 1, 1, 1, 1 }, // Middle
+        { 0, 0, 0, 0, 0 }, // Top
+        { 2, 2, 2, 2, 2 }, // Bottom
+        { 0, 1, 2, 1, 0 }, // V
+        { 2, 1, 0, 1, 2 }  // Inverted V
+    };
+    config.pays = {
+        { 0, 0, 0, 6, 50, 250 }, // Watermelon
+        { 0, 0, 0, 2, 12, 50 },  // Apple
+        { 0, 0, 0, 1, 3, 11 }    // Cherries
+    };
+    return config;
+}
+
+/**
+ * Constructor for the OutcomeEngine class.
+ * Copies the strips into flat tables and the lines into the payline
+ * evaluator; the configuration must be valid.
+ * @param config The machine to evaluate.
+ */
+OutcomeEngine::OutcomeEngine(const MachineConfig& config)
+    : mConfig(config), mReelCount(static_cast<int>(config.strips.size())), mRows(config.rows),
+    mLineCount(static_cast<int>(config.paylines.size())), mEvaluator(config) {
+    std::memset(mStripLengths, 0, sizeof(mStripLengths));
+
+    for (int reel = 0; reel < mReelCount; ++reel) {
+        const std::vector<int>& strip = config.strips[reel];
+        mStripLengths[reel] = static_cast<int>(strip.size());
+        for (int i = 0; i < mStripLengths[reel] + mRows - 1; ++i) {
+            mStrips[reel].push_back(static_cast<uint8_t>(strip[i % mStripLengths[reel]]));
+        }
+    }
+}
+
+/**
+ * Gets the machine this engine evaluates.
+ * @return The machine configuration.
+ */
+const MachineConfig& OutcomeEngine::getConfig() const {
+    return mConfig;
+}
+
+/**
+ * Gets the number of reels.
+ * @return The reel count.
+ */
+int OutcomeEngine::getReelCount() const {
+    return mReelCount;
+}
+
+/**
+ * Gets the number of paylines; a spin bets one line bet on each.
+ * @return The line count.
+ */
+int OutcomeEngine::getLineCount() const {
+    return mLineCount;
+}
+
+/**
+ * Gets the number of stops on a reel.
+ * @param reel The reel index.
+ * @return The strip length.
+ */
+int OutcomeEngine::getStripLength(int reel) const {
+    return mStripLengths[reel];
+}
+
+/**
+ * Draws a stop for every reel, each uniform over its strip, and evaluates the result.
+ * @param random The random stream to draw from.
+ * @param result Receives the stops, window and wins.
+ */
+void OutcomeEngine::spin(Random& random, SpinResult& result) const {
+    int stops[MachineConfig::MAX_REELS];
+    for (int reel = 0; reel < mReelCount; ++reel) {
+        stops[reel] = static_cast<int>(random.nextBounded(static_cast<uint32_t>(mStripLengths[reel])));
+    }
+    evaluate(stops, result);
+}
+
+/**
+ * Copies the window shown by a set of stops into one lane of a batch.
+ * @param stops The stop of each reel, in [0, strip length).
+ * @param window The lane to fill.
+ * @param batch Receives the window.
+ */
+void OutcomeEngine::fillWindow(const int* stops, int window, WindowBatch& batch) const {
+    for (int reel = 0; reel < mReelCount; ++reel) {
+        const uint8_t* shown = mStrips[reel].data() + stops[reel];
+        for (int row = 0; row < mRows; ++row) {
+            batch.cells[reel][row][window] = shown[row];
+        }
+    }
+}
+
+/**
+ * Computes the visible window and every paying line for a set of stops.
+ * @param stops The stop of each reel, in [0, strip length).
+ * @param result Receives the stops, window and wins.
+ */
+void OutcomeEngine::evaluate(const int* stops, SpinResult& result) const {
+    result.reelCount = mReelCount;
+    for (int reel = 0; reel < mReelCount; ++reel) {
+        const uint8_t* window = mStrips[reel].data() + stops[reel];
+        result.stops[reel] = stops[reel];
+        for (int row = 0; row < mRows; ++row) {
+            result.window[reel][row] = window[row];
+        }
+    }
+
+    WindowBatch batch;
+    LineScores scores[2];
+    batch.count = 1;
+    fillWindow(stops, 0, batch);
+    mEvaluator.evaluate(batch, 0, scores[0], scores[1]);
+
+    result.winCount = 0;
+    result.totalWin = 0;
+    for (int direction = 0; direction < (mEvaluator.paysBothWays() ? 2 : 1); ++direction) {
+        for (int line = 0; line < mLineCount; ++line) {
+            uint32_t pay = scores[direction].pay[line];
+            if (pay > 0) {
+                result.wins[result.winCount++] = { line, scores[direction].symbol[line], scores[direction].count[line], pay, direction == 1 };
+                result.totalWin += pay;
+            }
+        }
+    }
+}
+
+/**
+ * Computes only the total win for a set of stops.
+ * @param stops The stop of each reel, in [0, strip length).
+ * @return The total win in line bets.
+ */
+uint32_t OutcomeEngine::evaluateWin(const int* stops) const {
+    uint32_t win = 0;
+    evaluateWins(stops, 1, &win, nullptr);
+    return win;
+}
+
+/**
+ * Computes the total wins of many sets of stops, a batch of windows at a time.
+ * @param stops The stops of each spin, reel count values per spin.
+ * @param count The number of spins.
+ * @param wins Receives the total win of each spin in line bets.
+ * @param counts Receives the paying lines by symbol and run length, added to what it holds; may be nullptr.
+ */
+void OutcomeEngine::evaluateWins(const int* stops, int count, uint32_t* wins, LineCounts* counts) const {
+    WindowBatch batch;
+    for (int first = 0; first < count; first += WindowBatch::SIZE) {
+        batch.count = count - first < WindowBatch::SIZE ? count - first : WindowBatch::SIZE;
+        for (int window = 0; window < batch.count; ++window) {
+            fillWindow(stops + (first + window) * mReelCount, window, batch);
+        }
+        mEvaluator.evaluateBatch(batch, wins + first, counts);
+    }
+}
+
+/**
+ * Draws stops for many spins and computes their total wins. The stops are
+ * drawn spin by spin and reel by reel, as spin draws them.
+ * @param random The random stream to draw from.
+ * @param count The number of spins.
+ * @param wins Receives the total win of each spin in line bets.
+ * @param counts Receives the paying lines by symbol and run length, added to what it holds; may be nullptr.
+ */
+void OutcomeEngine::spinWins(Random& random, int count, uint32_t* wins, LineCounts* counts) const {
+    WindowBatch batch;
+    int stops[MachineConfig::MAX_REELS];
+    for (int first = 0; first < count; first += WindowBatch::SIZE) {
+        batch.count = count - first < WindowBatch::SIZE ? count - first : WindowBatch::SIZE;
+        for (int window = 0; window < batch.count; ++window) {
+            for (int reel = 0; reel < mReelCount; ++reel) {
+                stops[reel] = static_cast<int>(random.nextBounded(static_cast<uint32_t>(mStripLengths[reel])));
+            }
+            fillWindow(stops, window, batch);
+        }
+        mEvaluator.evaluateBatch(batch, wins + first, counts);
+    }
+}
+
+/**
+ * Selects the payline kernel; every kernel gives the same results.
+ * @param kernel The kernel.
+ * @return True if the kernel is used, false if the CPU does not support it.
+ */
+bool OutcomeEngine::setKernel(PaylineEvaluator::Kernel kernel) {
+    return mEvaluator.setKernel(kernel);
+}
+
+/**
+ * Gets the payline kernel in use.
+ * @return The kernel.
+ */
+PaylineEvaluator::Kernel OutcomeEngine::getKernel() const {
+    return mEvaluator.getKernel();
+}
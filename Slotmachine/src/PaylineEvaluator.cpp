@@ -0,0 +1,681 @@
+#include "PaylineEvaluator.h"
+#include "OutcomeEngine.h"
+#include <cstring>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define PAYLINE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit SSE4.1 and AVX2 instructions in functions marked for
+// them; MSVC always accepts the intrinsics. The CPU is checked before they run.
+#if defined(PAYLINE_X86) && (defined(__GNUC__) || defined(__clang__))
+#define TARGET_SSE41 __attribute__((target("sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE41
+#define TARGET_AVX2
+#endif
+
+/**
+ * Constructor for the PaylineEvaluator class.
+ * Copies the paylines and paytable into flat tables for the kernels and
+ * picks the fastest kernel the CPU supports.
+ * @param config The machine to evaluate; must be valid.
+ */
+PaylineEvaluator::PaylineEvaluator(const MachineConfig& config)
+    : mReelCount(static_cast<int>(config.strips.size())), mLineCount(static_cast<int>(config.paylines.size())),
+    mWild(config.wild), mBothWays(config.bothWays), mKernel(KERNEL_SCALAR),
+    mKernelFunction(&PaylineEvaluator::evaluateScalar), mKernelLanes(1) {
+    std::memset(mCellOffsets, 0, sizeof(mCellOffsets));
+    std::memset(mPayingSymbolCount, 0, sizeof(mPayingSymbolCount));
+    std::memset(mPayingSymbols, 0, sizeof(mPayingSymbols));
+    std::memset(mPayingRunStarts, 0, sizeof(mPayingRunStarts));
+    std::memset(mPayingRuns, 0, sizeof(mPayingRuns));
+    std::memset(mPays, 0, sizeof(mPays));
+
+    for (int line = 0; line < mLineCount; ++line) {
+        for (int reel = 0; reel < mReelCount; ++reel) {
+            int row = config.paylines[line][reel];
+            uint16_t offset = static_cast<uint16_t>((reel * WindowBatch::MAX_ROWS + row) * WindowBatch::SIZE);
+            mCellOffsets[0][line][reel] = offset;
+            mCellOffsets[1][line][mReelCount - 1 - reel] = offset;
+        }
+    }
+
+    // A run needs at least one symbol, so pays for a count of 0 are ignored
+    for (size_t symbol = 0; symbol < config.pays.size(); ++symbol) {
+        for (size_t count = 1; count < config.pays[symbol].size(); ++count) {
+            mPays[0][symbol][count] = config.pays[symbol][count];
+            mPays[1][symbol][count] = config.pays[symbol][count];
+        }
+        mPays[1][symbol][mReelCount] = 0; // Already paid from the left
+
+        for (int direction = 0; direction < 2; ++direction) {
+            int paying = mPayingSymbolCount[direction];
+            int runCount = mPayingRunStarts[direction][paying];
+            for (int count = 1; count <= mReelCount; ++count) {
+                if (mPays[direction][symbol][count] > 0) {
+                    mPayingRuns[direction][runCount++] = { static_cast<int>(symbol), count };
+                }
+            }
+            if (runCount > mPayingRunStarts[direction][paying]) {
+                mPayingSymbols[direction][paying] = static_cast<int>(symbol);
+                mPayingSymbolCount[direction] = paying + 1;
+                mPayingRunStarts[direction][paying + 1] = runCount;
+            }
+        }
+    }
+
+    setKernel(detectKernel());
+}
+
+/**
+ * Finds the fastest kernel the CPU supports, including the operating system
+ * support for saving the AVX registers.
+ * @return The kernel.
+ */
+PaylineEvaluator::Kernel PaylineEvaluator::detectKernel() {
+    if (isKernelSupported(KERNEL_AVX2)) {
+        return KERNEL_AVX2;
+    }
+    if (isKernelSupported(KERNEL_SSE41)) {
+        return KERNEL_SSE41;
+    }
+    return KERNEL_SCALAR;
+}
+
+/**
+ * Checks if a kernel can run on this CPU.
+ * @param kernel The kernel.
+ * @return True if the kernel is supported, false otherwise.
+ */
+bool PaylineEvaluator::isKernelSupported(Kernel kernel) {
+    if (kernel == KERNEL_SCALAR) {
+        return true;
+    }
+#if defined(PAYLINE_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int maxLeaf = info[0];
+    __cpuid(info, 1);
+    bool sse41 = (info[2] & (1 << 19)) != 0;
+    if (kernel == KERNEL_SSE41 || !sse41) {
+        return sse41;
+    }
+    bool osSavesAvx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+    if (!osSavesAvx || maxLeaf < 7) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#elif defined(PAYLINE_X86)
+    bool sse41 = __builtin_cpu_supports("sse4.1") != 0;
+    if (kernel == KERNEL_SSE41 || !sse41) {
+        return sse41;
+    }
+    return __builtin_cpu_supports("avx2") != 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Gets a kernel's name for reports.
+ * @param kernel The kernel.
+ * @return The name.
+ */
+const char* PaylineEvaluator::getKernelName(Kernel kernel) {
+    switch (kernel) {
+    case KERNEL_SSE41:
+        return "SSE4.1";
+    case KERNEL_AVX2:
+        return "AVX2";
+    default:
+        return "scalar";
+    }
+}
+
+/**
+ * Switches to another kernel; all kernels give identical results.
+ * @param kernel The kernel.
+ * @return True if the kernel is now used, false if the CPU does not support it.
+ */
+bool PaylineEvaluator::setKernel(Kernel kernel) {
+    if (!isKernelSupported(kernel)) {
+        return false;
+    }
+    mKernel = kernel;
+    switch (kernel) {
+    case KERNEL_SSE41:
+        mKernelFunction = &PaylineEvaluator::evaluateSse41;
+        mKernelLanes = 4;
+        break;
+    case KERNEL_AVX2:
+        mKernelFunction = &PaylineEvaluator::evaluateAvx2;
+        mKernelLanes = 8;
+        break;
+    default:
+        mKernelFunction = &PaylineEvaluator::evaluateScalar;
+        mKernelLanes = 1;
+        break;
+    }
+    return true;
+}
+
+/**
+ * Gets the kernel in use.
+ * @return The kernel.
+ */
+PaylineEvaluator::Kernel PaylineEvaluator::getKernel() const {
+    return mKernel;
+}
+
+/**
+ * Checks if lines also pay from the right.
+ * @return True if the machine pays both ways.
+ */
+bool PaylineEvaluator::paysBothWays() const {
+    return mBothWays;
+}
+
+/**
+ * Scores every line of one window.
+ * @param batch The windows.
+ * @param window The index of the window in the batch.
+ * @param leftToRight Receives the best win of each line from the left.
+ * @param rightToLeft Receives the best win of each line from the right, if the machine pays both ways.
+ */
+void PaylineEvaluator::evaluate(const WindowBatch& batch, int window, LineScores& leftToRight, LineScores& rightToLeft) const {
+    for (int direction = 0; direction < (mBothWays ? 2 : 1); ++direction) {
+        LineScores& scores = direction == 1 ? rightToLeft : leftToRight;
+        for (int line = 0; line < mLineCount; ++line) {
+            int symbol;
+            int count;
+            scores.pay[line] = scoreLine(batch, window, line, direction == 1, symbol, count);
+            scores.symbol[line] = scores.pay[line] > 0 ? symbol : -1;
+            scores.count[line] = scores.pay[line] > 0 ? count : 0;
+        }
+    }
+}
+
+/**
+ * Computes the total win of every window in a batch. Whole vectors of windows
+ * go to the selected kernel and the rest to the scalar one.
+ * @param batch The windows.
+ * @param wins Receives the total win of each window in line bets, batch.count values.
+ * @param counts Receives the paying lines by symbol and run length, added to what it holds; may be nullptr.
+ */
+void PaylineEvaluator::evaluateBatch(const WindowBatch& batch, uint32_t* wins, LineCounts* counts) const {
+    int vectorEnd = batch.count - batch.count % mKernelLanes;
+    if (vectorEnd > 0) {
+        (this->*mKernelFunction)(batch, 0, vectorEnd, wins, counts);
+    }
+    if (vectorEnd < batch.count) {
+        evaluateScalar(batch, vectorEnd, batch.count, wins, counts);
+    }
+}
+
+/**
+ * Finds the best win of one line of one window. Without a wild, a line can
+ * only run with the symbol on its first cell.
+ * @param batch The windows.
+ * @param window The index of the window in the batch.
+ * @param line The payline index.
+ * @param rightToLeft True to count the run from the last reel.
+ * @param symbol Receives the symbol of the run.
+ * @param count Receives the length of the run.
+ * @return The win in line bets, 0 if no run pays.
+ */
+uint32_t PaylineEvaluator::scoreLine(const WindowBatch& batch, int window, int line, bool rightToLeft, int& symbol, int& count) const {
+    const int direction = rightToLeft ? 1 : 0;
+    const uint8_t* cells = &batch.cells[0][0][window];
+    const uint16_t* offsets = mCellOffsets[direction][line];
+    const uint32_t (*pays)[MAX_REELS + 1] = mPays[direction];
+
+    if (mWild < 0) {
+        symbol = cells[offsets[0]];
+        count = 1;
+        while (count < mReelCount && cells[offsets[count]] == symbol) {
+            ++count;
+        }
+        return pays[symbol][count];
+    }
+
+    uint32_t best = 0;
+    symbol = -1;
+    count = 0;
+    for (int i = 0; i < mPayingSymbolCount[direction]; ++i) {
+        int candidate = mPayingSymbols[direction][i];
+        int run = 0;
+        while (run < mReelCount && (cells[offsets[run]] == candidate || cells[offsets[run]] == mWild)) {
+            ++run;
+        }
+        if (pays[candidate][run] > best) {
+            best = pays[candidate][run];
+            symbol = candidate;
+            count = run;
+        }
+    }
+    return best;
+}
+
+/**
+ * Portable kernel: one window at a time, one line at a time. Lines without a
+ * wild are scored inline, since they only run with their first symbol.
+ * @param batch The windows.
+ * @param begin The first window to evaluate.
+ * @param end One past the last window to evaluate.
+ * @param wins Receives the total win of each window, indexed like the batch.
+ * @param counts Receives the paying lines; may be nullptr.
+ */
+void PaylineEvaluator::evaluateScalar(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const {
+    for (int window = begin; window < end; ++window) {
+        const uint8_t* cells = &batch.cells[0][0][window];
+        uint32_t total = 0;
+        for (int direction = 0; direction < (mBothWays ? 2 : 1); ++direction) {
+            for (int line = 0; line < mLineCount; ++line) {
+                int symbol;
+                int count;
+                uint32_t pay;
+                if (mWild < 0) {
+                    const uint16_t* offsets = mCellOffsets[direction][line];
+                    symbol = cells[offsets[0]];
+                    count = 1;
+                    while (count < mReelCount && cells[offsets[count]] == symbol) {
+                        ++count;
+                    }
+                    pay = mPays[direction][symbol][count];
+                }
+                else {
+                    pay = scoreLine(batch, window, line, direction == 1, symbol, count);
+                }
+                total += pay;
+                if (counts != nullptr && pay > 0) {
+                    ++counts->lines[symbol][count];
+                }
+            }
+        }
+        wins[window] = total;
+    }
+}
+
+#if defined(PAYLINE_X86)
+
+/**
+ * Loads one cell of four consecutive windows, one symbol per 32-bit lane.
+ * @param cells The cell of the first window.
+ * @return The symbols.
+ */
+static TARGET_SSE41 __m128i loadCellsSse41(const uint8_t* cells) {
+    int32_t packed;
+    std::memcpy(&packed, cells, sizeof(packed));
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+}
+
+/**
+ * Looks up pays[index + 1] in every lane, for indices in [0, 8). SSE has no
+ * variable 32-bit permute, so both halves of the table are byte-shuffled and
+ * the right one is picked.
+ * @param pays The pays of one symbol by run length.
+ * @param index The run length minus one in each lane.
+ * @return The pay in each lane.
+ */
+static TARGET_SSE41 __m128i lookupPaySse41(const uint32_t* pays, __m128i index) {
+    const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pays + 1));
+    const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pays + 5));
+    __m128i offset = _mm_slli_epi32(_mm_and_si128(index, _mm_set1_epi32(3)), 2);
+    __m128i control = _mm_add_epi8(_mm_shuffle_epi8(offset, _mm_setr_epi8(0, 0, 0, 0, 4, 4, 4, 4, 8, 8, 8, 8, 12, 12, 12, 12)),
+        _mm_set1_epi32(0x03020100));
+    __m128i upper = _mm_cmpgt_epi32(index, _mm_set1_epi32(3));
+    return _mm_blendv_epi8(_mm_shuffle_epi8(low, control), _mm_shuffle_epi8(high, control), upper);
+}
+
+/**
+ * Adds the four-bit line counts of the paying runs to their 32-bit tallies
+ * and clears the fields.
+ * @param fields The counts of each paying symbol, four bits per run length.
+ * @param tallies The counts of each paying run.
+ * @param symbolCount The number of paying symbols.
+ * @param runStarts The first paying run of each paying symbol.
+ * @param runShifts The bit offset of the field of each paying run.
+ */
+static TARGET_SSE41 void widenFieldsSse41(__m128i* fields, __m128i* tallies, int symbolCount, const int* runStarts,
+    const int* runShifts) {
+    const __m128i mask = _mm_set1_epi32(15);
+    for (int i = 0; i < symbolCount; ++i) {
+        for (int r = runStarts[i]; r < runStarts[i + 1]; ++r) {
+            __m128i field = _mm_srl_epi32(fields[i], _mm_cvtsi32_si128(runShifts[r]));
+            tallies[r] = _mm_add_epi32(tallies[r], _mm_and_si128(field, mask));
+        }
+        fields[i] = _mm_setzero_si128();
+    }
+}
+
+/**
+ * Scores every line of four windows at a time in one direction and adds the
+ * wins. Without a wild, a line only runs with its first symbol, so the run is
+ * counted once and its pay looked up per paying symbol; with a wild, every
+ * paying symbol's run is counted and the best pay kept. No lane branches on
+ * its symbols. Paying lines are counted in four-bit fields, one per run
+ * length, in one vector per paying symbol, so a line costs one add per symbol
+ * rather than a compare per paying run; a lane adds at most one per line, so
+ * the fields are widened every 15 lines before they can carry.
+ * @param batch The windows.
+ * @param begin The first window to evaluate.
+ * @param end One past the last window to evaluate; end - begin must be a multiple of 4.
+ * @param direction 0 for runs from the left, 1 for runs from the right.
+ * @param wins The total win of each window, indexed like the batch; the wins are added.
+ * @param counts Receives the paying lines if Count is set.
+ */
+template <bool Wild, bool Count>
+TARGET_SSE41 void PaylineEvaluator::scoreSse41(const WindowBatch& batch, int begin, int end, int direction, uint32_t* wins, LineCounts* counts) const {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i wild = _mm_set1_epi32(mWild);
+    const __m128i bias = _mm_set1_epi32(127 - 4); // Float exponent bias, less one field
+    const int* symbols = mPayingSymbols[direction];
+    const int symbolCount = mPayingSymbolCount[direction];
+    const int* runStarts = mPayingRunStarts[direction];
+    const PayingRun* runs = mPayingRuns[direction];
+    const uint32_t (*pays)[MAX_REELS + 1] = mPays[direction];
+
+    // Paying lines per lane: by paying symbol and run length since the last
+    // widening, and by paying run
+    const int widenInterval = 15;
+    __m128i fields[MAX_SYMBOLS];
+    __m128i tallies[MAX_SYMBOLS * MAX_REELS];
+    int runShifts[MAX_SYMBOLS * MAX_REELS];
+    int pending = 0;
+    for (int i = 0; Count && i < symbolCount; ++i) {
+        fields[i] = zero;
+    }
+    for (int i = 0; Count && i < runStarts[symbolCount]; ++i) {
+        tallies[i] = zero;
+        runShifts[i] = 4 * (runs[i].count - 1);
+    }
+
+    for (int window = begin; window < end; window += 4) {
+        const uint8_t* cells = &batch.cells[0][0][window];
+        __m128i total = _mm_loadu_si128(reinterpret_cast<const __m128i*>(wins + window));
+        for (int line = 0; line < mLineCount; ++line) {
+            const uint16_t* offsets = mCellOffsets[direction][line];
+            __m128i pay = zero;
+            __m128i symbol;
+            __m128i count;
+            if (!Wild) {
+                symbol = loadCellsSse41(cells + offsets[0]);
+                __m128i alive = _mm_set1_epi32(-1);
+                count = one;
+                for (int step = 1; step < mReelCount; ++step) {
+                    alive = _mm_and_si128(alive, _mm_cmpeq_epi32(loadCellsSse41(cells + offsets[step]), symbol));
+                    count = _mm_sub_epi32(count, alive);
+                }
+                __m128i index = _mm_sub_epi32(count, one);
+                for (int i = 0; i < symbolCount; ++i) {
+                    __m128i shown = _mm_cmpeq_epi32(symbol, _mm_set1_epi32(symbols[i]));
+                    pay = _mm_or_si128(pay, _mm_and_si128(shown, lookupPaySse41(pays[symbols[i]], index)));
+                }
+            }
+            else {
+                symbol = _mm_set1_epi32(-1);
+                count = zero;
+                for (int i = 0; i < symbolCount; ++i) {
+                    __m128i candidate = _mm_set1_epi32(symbols[i]);
+                    __m128i alive = _mm_set1_epi32(-1);
+                    __m128i run = zero;
+                    for (int step = 0; step < mReelCount; ++step) {
+                        __m128i shown = loadCellsSse41(cells + offsets[step]);
+                        alive = _mm_and_si128(alive, _mm_or_si128(_mm_cmpeq_epi32(shown, candidate), _mm_cmpeq_epi32(shown, wild)));
+                        run = _mm_sub_epi32(run, alive);
+                    }
+                    // A run of 0 looks up a wrong pay, which is masked off
+                    __m128i runPay = _mm_and_si128(_mm_cmpgt_epi32(run, zero), lookupPaySse41(pays[symbols[i]], _mm_sub_epi32(run, one)));
+                    __m128i better = _mm_cmpgt_epi32(runPay, pay);
+                    pay = _mm_blendv_epi8(pay, runPay, better);
+                    symbol = _mm_blendv_epi8(symbol, candidate, better);
+                    count = _mm_blendv_epi8(count, run, better);
+                }
+            }
+            total = _mm_add_epi32(total, pay);
+
+            // Adds 16^(count - 1) for the lanes showing the symbol, built as
+            // the exponent of a float; other lanes get 2^-4, which truncates to 0
+            for (int i = 0; Count && i < symbolCount; ++i) {
+                __m128i length = _mm_and_si128(_mm_cmpeq_epi32(symbol, _mm_set1_epi32(symbols[i])), count);
+                __m128i exponent = _mm_slli_epi32(_mm_add_epi32(_mm_slli_epi32(length, 2), bias), 23);
+                fields[i] = _mm_add_epi32(fields[i], _mm_cvttps_epi32(_mm_castsi128_ps(exponent)));
+            }
+            if (Count && ++pending == widenInterval) {
+                widenFieldsSse41(fields, tallies, symbolCount, runStarts, runShifts);
+                pending = 0;
+            }
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(wins + window), total);
+    }
+
+    // Only paying runs are widened; fields of other lengths are dropped
+    if (Count) {
+        widenFieldsSse41(fields, tallies, symbolCount, runStarts, runShifts);
+    }
+    for (int r = 0; Count && r < runStarts[symbolCount]; ++r) {
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), tallies[r]);
+        counts->lines[runs[r].symbol][runs[r].count] += uint64_t(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+}
+
+/**
+ * SSE4.1 kernel: four windows per vector, one 32-bit lane each.
+ * @param batch The windows.
+ * @param begin The first window to evaluate.
+ * @param end One past the last window to evaluate; end - begin must be a multiple of 4.
+ * @param wins Receives the total win of each window, indexed like the batch.
+ * @param counts Receives the paying lines; may be nullptr.
+ */
+TARGET_SSE41 void PaylineEvaluator::evaluateSse41(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const {
+    std::memset(wins + begin, 0, (end - begin) * sizeof(uint32_t));
+    for (int direction = 0; direction < (mBothWays ? 2 : 1); ++direction) {
+        if (mWild >= 0) {
+            if (counts != nullptr) {
+                scoreSse41<true, true>(batch, begin, end, direction, wins, counts);
+            }
+            else {
+                scoreSse41<true, false>(batch, begin, end, direction, wins, counts);
+            }
+        }
+        else if (counts != nullptr) {
+            scoreSse41<false, true>(batch, begin, end, direction, wins, counts);
+        }
+        else {
+            scoreSse41<false, false>(batch, begin, end, direction, wins, counts);
+        }
+    }
+}
+
+/**
+ * Loads one cell of eight consecutive windows, one symbol per 32-bit lane.
+ * @param cells The cell of the first window.
+ * @return The symbols.
+ */
+static TARGET_AVX2 __m256i loadCellsAvx2(const uint8_t* cells) {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(cells)));
+}
+
+/**
+ * Adds the four-bit line counts of the paying runs to their 32-bit tallies
+ * and clears the fields.
+ * @param fields The counts of each paying symbol, four bits per run length.
+ * @param tallies The counts of each paying run.
+ * @param symbolCount The number of paying symbols.
+ * @param runStarts The first paying run of each paying symbol.
+ * @param runShifts The bit offset of the field of each paying run.
+ */
+static TARGET_AVX2 void widenFieldsAvx2(__m256i* fields, __m256i* tallies, int symbolCount, const int* runStarts,
+    const int* runShifts) {
+    const __m256i mask = _mm256_set1_epi32(15);
+    for (int i = 0; i < symbolCount; ++i) {
+        for (int r = runStarts[i]; r < runStarts[i + 1]; ++r) {
+            __m256i field = _mm256_srlv_epi32(fields[i], _mm256_set1_epi32(runShifts[r]));
+            tallies[r] = _mm256_add_epi32(tallies[r], _mm256_and_si256(field, mask));
+        }
+        fields[i] = _mm256_setzero_si256();
+    }
+}
+
+/**
+ * scoreSse41 on eight windows at a time.
+ * @param batch The windows.
+ * @param begin The first window to evaluate.
+ * @param end One past the last window to evaluate; end - begin must be a multiple of 8.
+ * @param direction 0 for runs from the left, 1 for runs from the right.
+ * @param wins The total win of each window, indexed like the batch; the wins are added.
+ * @param counts Receives the paying lines if Count is set.
+ */
+template <bool Wild, bool Count>
+TARGET_AVX2 void PaylineEvaluator::scoreAvx2(const WindowBatch& batch, int begin, int end, int direction, uint32_t* wins, LineCounts* counts) const {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i wild = _mm256_set1_epi32(mWild);
+    const int* symbols = mPayingSymbols[direction];
+    const int symbolCount = mPayingSymbolCount[direction];
+    const int* runStarts = mPayingRunStarts[direction];
+    const PayingRun* runs = mPayingRuns[direction];
+    const uint32_t (*pays)[MAX_REELS + 1] = mPays[direction];
+
+    // Paying lines per lane: by paying symbol and run length since the last
+    // widening, and by paying run
+    const int widenInterval = 15;
+    __m256i fields[MAX_SYMBOLS];
+    __m256i tallies[MAX_SYMBOLS * MAX_REELS];
+    int runShifts[MAX_SYMBOLS * MAX_REELS];
+    int pending = 0;
+    for (int i = 0; Count && i < symbolCount; ++i) {
+        fields[i] = zero;
+    }
+    for (int i = 0; Count && i < runStarts[symbolCount]; ++i) {
+        tallies[i] = zero;
+        runShifts[i] = 4 * (runs[i].count - 1);
+    }
+
+    for (int window = begin; window < end; window += 8) {
+        const uint8_t* cells = &batch.cells[0][0][window];
+        __m256i total = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(wins + window));
+        for (int line = 0; line < mLineCount; ++line) {
+            const uint16_t* offsets = mCellOffsets[direction][line];
+            __m256i pay = zero;
+            __m256i symbol;
+            __m256i count;
+            if (!Wild) {
+                symbol = loadCellsAvx2(cells + offsets[0]);
+                __m256i alive = _mm256_set1_epi32(-1);
+                count = one;
+                for (int step = 1; step < mReelCount; ++step) {
+                    alive = _mm256_and_si256(alive, _mm256_cmpeq_epi32(loadCellsAvx2(cells + offsets[step]), symbol));
+                    count = _mm256_sub_epi32(count, alive);
+                }
+                __m256i index = _mm256_sub_epi32(count, one);
+                for (int i = 0; i < symbolCount; ++i) {
+                    __m256i table = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pays[symbols[i]] + 1));
+                    __m256i shown = _mm256_cmpeq_epi32(symbol, _mm256_set1_epi32(symbols[i]));
+                    pay = _mm256_or_si256(pay, _mm256_and_si256(shown, _mm256_permutevar8x32_epi32(table, index)));
+                }
+            }
+            else {
+                symbol = _mm256_set1_epi32(-1);
+                count = zero;
+                for (int i = 0; i < symbolCount; ++i) {
+                    __m256i candidate = _mm256_set1_epi32(symbols[i]);
+                    __m256i table = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pays[symbols[i]] + 1));
+                    __m256i alive = _mm256_set1_epi32(-1);
+                    __m256i run = zero;
+                    for (int step = 0; step < mReelCount; ++step) {
+                        __m256i shown = loadCellsAvx2(cells + offsets[step]);
+                        alive = _mm256_and_si256(alive, _mm256_or_si256(_mm256_cmpeq_epi32(shown, candidate), _mm256_cmpeq_epi32(shown, wild)));
+                        run = _mm256_sub_epi32(run, alive);
+                    }
+                    // A run of 0 wraps to the last table entry, which is masked off
+                    __m256i runPay = _mm256_and_si256(_mm256_cmpgt_epi32(run, zero),
+                        _mm256_permutevar8x32_epi32(table, _mm256_sub_epi32(run, one)));
+                    __m256i better = _mm256_cmpgt_epi32(runPay, pay);
+                    pay = _mm256_blendv_epi8(pay, runPay, better);
+                    symbol = _mm256_blendv_epi8(symbol, candidate, better);
+                    count = _mm256_blendv_epi8(count, run, better);
+                }
+            }
+            total = _mm256_add_epi32(total, pay);
+
+            // Adds 1 << 4 * (count - 1) for the lanes showing the symbol; the
+            // shift of other lanes is out of range and adds nothing
+            for (int i = 0; Count && i < symbolCount; ++i) {
+                __m256i length = _mm256_and_si256(_mm256_cmpeq_epi32(symbol, _mm256_set1_epi32(symbols[i])), count);
+                __m256i shift = _mm256_slli_epi32(_mm256_sub_epi32(length, one), 2);
+                fields[i] = _mm256_add_epi32(fields[i], _mm256_sllv_epi32(one, shift));
+            }
+            if (Count && ++pending == widenInterval) {
+                widenFieldsAvx2(fields, tallies, symbolCount, runStarts, runShifts);
+                pending = 0;
+            }
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(wins + window), total);
+    }
+
+    // Only paying runs are widened; fields of other lengths are dropped
+    if (Count) {
+        widenFieldsAvx2(fields, tallies, symbolCount, runStarts, runShifts);
+    }
+    for (int r = 0; Count && r < runStarts[symbolCount]; ++r) {
+        uint32_t lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), tallies[r]);
+        uint64_t sum = 0;
+        for (int lane = 0; lane < 8; ++lane) {
+            sum += lanes[lane];
+        }
+        counts->lines[runs[r].symbol][runs[r].count] += sum;
+    }
+}
+
+/**
+ * AVX2 kernel: eight windows per vector, one 32-bit lane each. Pays are
+ * looked up with one variable permute per symbol.
+ * @param batch The windows.
+ * @param begin The first window to evaluate.
+ * @param end One past the last window to evaluate; end - begin must be a multiple of 8.
+ * @param wins Receives the total win of each window, indexed like the batch.
+ * @param counts Receives the paying lines; may be nullptr.
+ */
+TARGET_AVX2 void PaylineEvaluator::evaluateAvx2(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const {
+    std::memset(wins + begin, 0, (end - begin) * sizeof(uint32_t));
+    for (int direction = 0; direction < (mBothWays ? 2 : 1); ++direction) {
+        if (mWild >= 0) {
+            if (counts != nullptr) {
+                scoreAvx2<true, true>(batch, begin, end, direction, wins, counts);
+            }
+            else {
+                scoreAvx2<true, false>(batch, begin, end, direction, wins, counts);
+            }
+        }
+        else if (counts != nullptr) {
+            scoreAvx2<false, true>(batch, begin, end, direction, wins, counts);
+        }
+        else {
+            scoreAvx2<false, false>(batch, begin, end, direction, wins, counts);
+        }
+    }
+}
+
+#else
+
+// Never selected: isKernelSupported reports the SIMD kernels as unsupported
+void PaylineEvaluator::evaluateSse41(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const {
+    evaluateScalar(batch, begin, end, wins, counts);
+}
+
+void PaylineEvaluator::evaluateAvx2(const WindowBatch& batch, int begin, int end, uint32_t* wins, LineCounts* counts) const {
+    evaluateScalar(batch, begin, end, wins, counts);
+}
+
+#endif
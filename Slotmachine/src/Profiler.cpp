@@ -0,0 +1,188 @@
+#include "Profiler.h"
+#include <stdio.h>
+#include <algorithm>
+
+std::atomic<bool> Profiler::sEnabled(false);
+std::mutex Profiler::sRingsMutex;
+std::vector<std::unique_ptr<Profiler::ThreadRing>> Profiler::sRings;
+
+/**
+ * Turns zone recording on or off for all threads.
+ * @param enabled True to record zones, false to stop.
+ */
+void Profiler::setEnabled(bool enabled) {
+    sEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * Checks if zones are being recorded.
+ * @return True if the profiler is enabled, false otherwise.
+ */
+bool Profiler::isEnabled() {
+    return sEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * Names the calling thread in exported traces.
+ * @param name The thread name; must be a string literal or otherwise outlive the profiler.
+ */
+void Profiler::setThreadName(const char* name) {
+    ThreadRing* ring = getThreadRing();
+    std::lock_guard<std::mutex> lock(sRingsMutex);
+    ring->threadName = name;
+}
+
+/**
+ * Gets the ring buffer of the calling thread, creating it on first use.
+ * The zone slots are only allocated once the thread records a zone.
+ * @return The ring buffer, owned by the profiler.
+ */
+Profiler::ThreadRing* Profiler::getThreadRing() {
+    static thread_local ThreadRing* ring = nullptr;
+    if (ring == nullptr) {
+        std::unique_ptr<ThreadRing> created(new ThreadRing());
+        created->head.store(0, std::memory_order_relaxed);
+        created->threadName = nullptr;
+
+        std::lock_guard<std::mutex> lock(sRingsMutex);
+        created->threadId = static_cast<int>(sRings.size()) + 1;
+        ring = created.get();
+        sRings.push_back(std::move(created));
+    }
+    return ring;
+}
+
+/**
+ * Allocates the zone slots of a ring, all marked as never written.
+ * @param ring The calling thread's ring buffer.
+ */
+void Profiler::allocateSlots(ThreadRing* ring) {
+    std::unique_ptr<ZoneSlot[]> slots(new ZoneSlot[RING_CAPACITY]);
+    for (int i = 0; i < RING_CAPACITY; ++i) {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(sRingsMutex);
+    ring->slots = std::move(slots);
+}
+
+/**
+ * Appends a finished zone to the calling thread's ring buffer.
+ * Never blocks once the thread has recorded its first zone.
+ * @param name The zone name; must be a string literal.
+ * @param start The performance counter value when the zone began.
+ * @param end The performance counter value when the zone ended.
+ */
+void Profiler::recordZone(const char* name, Uint64 start, Uint64 end) {
+    ThreadRing* ring = getThreadRing();
+    if (!ring->slots) {
+        allocateSlots(ring);
+    }
+    Uint64 head = ring->head.load(std::memory_order_relaxed);
+    ZoneSlot& slot = ring->slots[head % RING_CAPACITY];
+    slot.sequence.store(head * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+    slot.sequence.store(head * 2 + 2, std::memory_order_release);
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * Writes the zones held in all ring buffers as a Chrome trace event file.
+ * Zones that a thread overwrote while they were being copied are skipped.
+ * Threads that never recorded a zone are left out.
+ * @param path The output file path.
+ * @return True if the file was written, false otherwise.
+ */
+bool Profiler::writeChromeTrace(const std::string& path) {
+    struct ThreadZones {
+        int threadId;
+        const char* threadName;
+        std::vector<Zone> zones;
+    };
+
+    std::vector<ThreadZones> threads;
+    Uint64 origin = 0;
+    {
+        std::lock_guard<std::mutex> lock(sRingsMutex);
+        for (const auto& ring : sRings) {
+            if (!ring->slots) {
+                continue;
+            }
+            ThreadZones thread;
+            thread.threadId = ring->threadId;
+            thread.threadName = ring->threadName;
+
+            Uint64 head = ring->head.load(std::memory_order_acquire);
+            Uint64 first = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+            for (Uint64 i = first; i < head; ++i) {
+                // Keep the zone only if its slot still held zone i before and after the copy
+                const ZoneSlot& slot = ring->slots[i % RING_CAPACITY];
+                Uint64 written = i * 2 + 2;
+                if (slot.sequence.load(std::memory_order_acquire) != written) {
+                    continue;
+                }
+                Zone zone;
+                zone.name = slot.name.load(std::memory_order_relaxed);
+                zone.start = slot.start.load(std::memory_order_relaxed);
+                zone.end = slot.end.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == written) {
+                    thread.zones.push_back(zone);
+                }
+            }
+
+            for (const Zone& zone : thread.zones) {
+                origin = origin == 0 ? zone.start : std::min(origin, zone.start);
+            }
+            threads.push_back(thread);
+        }
+    }
+
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        printf("Unable to write profiler trace %s!\n", path.c_str());
+        return false;
+    }
+
+    double usPerTick = 1000000.0 / SDL_GetPerformanceFrequency();
+    size_t count = 0;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    bool first = true;
+    for (const ThreadZones& thread : threads) {
+        if (thread.threadName != nullptr) {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                first ? "" : ",\n", thread.threadId, thread.threadName);
+            first = false;
+        }
+        for (const Zone& zone : thread.zones) {
+            fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                first ? "" : ",\n", zone.name, thread.threadId,
+                (zone.start - origin) * usPerTick, (zone.end - zone.start) * usPerTick);
+            first = false;
+            ++count;
+        }
+    }
+    fprintf(file, "\n]}\n");
+    bool success = fclose(file) == 0;
+
+    if (success) {
+        printf("Wrote %zu profiler zones to %s\n", count, path.c_str());
+    }
+    return success;
+}
+
+/**
+ * Gets the number of zones recorded by all threads since startup,
+ * including ones that have since been overwritten.
+ * @return The zone count.
+ */
+Uint64 Profiler::getZoneCount() {
+    std::lock_guard<std::mutex> lock(sRingsMutex);
+    Uint64 total = 0;
+    for (const auto& ring : sRings) {
+        total += ring->head.load(std::memory_order_relaxed);
+    }
+    return total;
+}
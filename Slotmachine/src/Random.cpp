@@ -0,0 +1,179 @@
+#include "Random.h"
+#include <chrono>
+#include <random>
+#include <cstring>
+
+/**
+ * Advances a splitmix64 state and returns its next output.
+ * Used to spread a single seed over the four words of xoshiro state.
+ * @param state The splitmix64 state.
+ * @return The next 64-bit output.
+ */
+static uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9e3779b97f4a7c15ull);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * Constructor for the Random class.
+ * @param seed The seed; equal seeds give equal sequences.
+ */
+Random::Random(uint64_t seed) {
+    this->seed(seed);
+}
+
+/**
+ * Restarts the generator from a seed.
+ * @param seed The seed; equal seeds give equal sequences.
+ */
+void Random::seed(uint64_t seed) {
+    uint64_t state = seed;
+    for (uint64_t& word : mState) {
+        word = splitMix64(state);
+    }
+}
+
+/**
+ * Makes a seed that differs between runs.
+ * @return A seed mixed from std::random_device and the high-resolution clock.
+ */
+uint64_t Random::makeSeed() {
+    uint64_t seed = static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    try {
+        std::random_device device;
+        seed ^= (static_cast<uint64_t>(device()) << 32) | device();
+    }
+    catch (...) {
+        // No entropy source; the clock alone still differs between runs
+    }
+    return splitMix64(seed);
+}
+
+/**
+ * Gets a uniformly distributed integer in a closed range.
+ * @param min The smallest value.
+ * @param max The largest value; must not be less than min.
+ * @return The random value.
+ */
+int Random::nextInt(int min, int max) {
+    uint32_t span = static_cast<uint32_t>(static_cast<int64_t>(max) - min) + 1;
+    if (span == 0) {
+        return static_cast<int>(next() >> 32); // The whole 32-bit range
+    }
+    return static_cast<int>(min + static_cast<int64_t>(nextBounded(span)));
+}
+
+/**
+ * Gets a uniformly distributed double in [0, 1).
+ * @return The random value, a multiple of 2^-53.
+ */
+double Random::nextDouble() {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * Gets a uniformly distributed float in [min, max).
+ * @param min The lower bound.
+ * @param max The upper bound.
+ * @return The random value.
+ */
+float Random::nextFloat(float min, float max) {
+    float unit = (next() >> 40) * (1.0f / 16777216.0f); // 24 bits fill a float mantissa
+    return min + (max - min) * unit;
+}
+
+/**
+ * Fills an array with random 64-bit values.
+ * @param values The destination array.
+ * @param count The number of values to write.
+ */
+void Random::fill(uint64_t* values, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = next();
+    }
+}
+
+/**
+ * Fills an array with unbiased random values in [0, bound).
+ * @param values The destination array.
+ * @param count The number of values to write.
+ * @param bound The exclusive upper bound; must be non-zero.
+ */
+void Random::fillBounded(uint32_t* values, size_t count, uint32_t bound) {
+    for (size_t i = 0; i < count; ++i) {
+        values[i] = nextBounded(bound);
+    }
+}
+
+/**
+ * Fills a buffer with random bytes.
+ * @param bytes The destination buffer.
+ * @param size The number of bytes to write.
+ */
+void Random::fillBytes(void* bytes, size_t size) {
+    unsigned char* out = static_cast<unsigned char*>(bytes);
+    while (size >= sizeof(uint64_t)) {
+        uint64_t value = next();
+        std::memcpy(out, &value, sizeof(value));
+        out += sizeof(value);
+        size -= sizeof(value);
+    }
+    if (size > 0) {
+        uint64_t value = next();
+        std::memcpy(out, &value, size);
+    }
+}
+
+/**
+ * Advances the generator by 2^128 values, as if next() had been called that often.
+ */
+void Random::jump() {
+    static const uint64_t JUMP[4] = {
+        0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull, 0x39abdc4529b1661cull
+    };
+    jump(JUMP);
+}
+
+/**
+ * Advances the generator by 2^192 values, e.g. to give each machine in a
+ * cluster its own range of jump() streams.
+ */
+void Random::longJump() {
+    static const uint64_t LONG_JUMP[4] = {
+        0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull, 0x39109bb02acbe635ull
+    };
+    jump(LONG_JUMP);
+}
+
+/**
+ * Applies a jump polynomial to the state.
+ * @param polynomial The jump polynomial of the xoshiro256 linear engine.
+ */
+void Random::jump(const uint64_t (&polynomial)[4]) {
+    uint64_t state[4] = { 0, 0, 0, 0 };
+    for (uint64_t word : polynomial) {
+        for (int bit = 0; bit < 64; ++bit) {
+            if (word & (1ull << bit)) {
+                for (int i = 0; i < 4; ++i) {
+                    state[i] ^= mState[i];
+                }
+            }
+            next();
+        }
+    }
+    for (int i = 0; i < 4; ++i) {
+        mState[i] = state[i];
+    }
+}
+
+/**
+ * Hands out the current stream and moves this generator 2^128 values ahead.
+ * @return A generator that will not overlap with this one for 2^128 values.
+ */
+Random Random::split() {
+    Random stream = *this;
+    jump();
+    return stream;
+}
@@ -1,55 +1,32 @@
 ﻿#include "Reel.h"
+#include "Profiler.h"
 #include <SDL_image.h>
 #include <stdio.h>
 #include <cmath> // For std::fmod
-#include <cstdlib> // For std::rand()
-#include <ctime>   // For std::time()
+#include <algorithm> // For std::min
 
 /**
  * Constructor for the Reel class.
- * Initializes the reel with the given parameters and loads the icons.
+ * Initializes the reel with the given parameters.
  * @param renderer The custom Renderer to use for rendering.
+ * @param atlas The IconAtlas holding the icons shared by all reels.
  * @param x The x-coordinate of the reel.
  * @param y The y-coordinate of the reel.
  * @param w The width of the reel.
  * @param h The height of the reel.
- * @param iconPaths A vector of file paths to the icons.
+ * The spin itself is simulated by ReelPhysics; the reel only draws the published state.
  */
-Reel::Reel(std::shared_ptr<Renderer> renderer, int x, int y, int w, int h, const std::vector<std::string>& iconPaths)
-    : mRenderer(renderer), mReelRect{ x, y, w, h }, mCurrentIconIndex(0), mSpinning(false), mSpinDuration(2000),
-    mStartPosition(0), mSpinSpeed(1.0f), mMaxPosition(1000), mStartPositionOffset(0), mStopDelay(0) {
-    loadIcons(iconPaths);
-    if (!mIcons.empty()) {
-        SDL_QueryTexture(mIcons[0], NULL, NULL, NULL, &mOriginalIconHeight);
-    }
+Reel::Reel(std::shared_ptr<Renderer> renderer, std::shared_ptr<IconAtlas> atlas, int x, int y, int w, int h)
+    : mRenderer(renderer), mAtlas(atlas), mReelRect{ x, y, w, h }, mStartPosition(0), mRows(1),
+    mStripTexture(nullptr), mStripX(0), mLayoutTexture(nullptr) {
     mClipRect = { x, y, w, h }; // Initialize the clip rectangle
 }
 
 /**
  * Destructor for the Reel class.
- * Cleans up the loaded textures.
- */
-Reel::~Reel() {
-    for (auto texture : mIcons) {
-        SDL_DestroyTexture(texture);
-    }
-}
-
-/**
- * Loads the icons from the given file paths.
- * @param iconPaths A vector of file paths to the icons.
+ * The icon atlas is released with the last reel that uses it.
  */
-void Reel::loadIcons(const std::vector<std::string>& iconPaths) {
-    for (const auto& path : iconPaths) {
-        SDL_Texture* texture = mRenderer->loadTexture(path);
-        if (texture == nullptr) {
-            printf("Unable to load image %s!\n", path.c_str());
-        }
-        else {
-            mIcons.push_back(texture);
-        }
-    }
-}
+Reel::~Reel() {}
 
 /**
  * Sets the clipping rectangle for the reel.
@@ -60,178 +37,165 @@ void Reel::setClipRect(const SDL_Rect& clipRect) {
 }
 
 /**
- * Renders the reel, updating its position if it is spinning.
- * @param deltaTime The time elapsed since the last frame.
+ * Sets the symbols on the reel strip. Invalidates the cached layout, so the
+ * strip must be baked again.
+ * @param symbols The atlas icon at each stop, top to bottom.
+ * @param rows The number of stops visible at once.
  */
-void Reel::render(Uint32 deltaTime) {
-    if (mSpinning) {
-        update(deltaTime); // Update the position of the reel
-    }
-
-    mRenderer->setDrawColor(0, 0, 0, 255); // Set a draw color for the clipping rectangle if needed
-    mRenderer->fillRect(mClipRect); // Fill the rectangle with the draw color
-    SDL_RenderSetClipRect(mRenderer->getSDLRenderer(), &mClipRect); // Set the clipping rectangle
-
-    size_t iconCount = mIcons.size();
-    if (iconCount == 0) return; // Avoid division by zero
-
-    int iconHeight = mReelRect.h / static_cast<int>(iconCount);
-
-    // Render icons in a loop to ensure seamless scrolling
-    for (int i = -1; i <= 1; ++i) { // Extend rendering to cover the reel height
-        int yOffset = (i * mReelRect.h) - mStartPosition;
-
-        // Render each icon at the calculated yOffset
-        for (size_t j = 0; j < iconCount; ++j) {
-            int currentYOffset = yOffset + static_cast<int>(j) * iconHeight;
-            renderIcon(static_cast<int>(j), currentYOffset, iconHeight);
-        }
-    }
-
-    SDL_RenderSetClipRect(mRenderer->getSDLRenderer(), NULL); // Reset the clipping rectangle
+void Reel::setStrip(const std::vector<int>& symbols, int rows) {
+    mStrip = symbols;
+    mRows = std::max(1, rows);
+    mLayoutTexture = nullptr;
+    mRenderer->invalidate(mClipRect);
 }
 
 /**
- * Renders a single icon at the specified position.
- * @param index The index of the icon to render.
- * @param yOffset The y-offset for rendering the icon.
- * @param iconHeight The height of the icon.
+ * Gets the size of the area one icon is fitted into.
+ * @return The cell width and height in pixels.
  */
-void Reel::renderIcon(int index, int yOffset, int iconHeight) {
-    int borderOffset = 22; // Border width
-    int drawableWidth = mReelRect.w - 2 * borderOffset; // Drawable width within the border
-    int drawableHeight = iconHeight; // Height of the drawable area for one icon
-
-    // Calculate icon width and height based on the drawable area
-    int iconWidth = drawableWidth; // Use full width available within the drawable area
-    int renderIconHeight = iconHeight; // Use full height of the icon
-
-    // Scale the icon to fit within the drawable area while maintaining aspect ratio
-    SDL_Rect iconSize;
-    SDL_QueryTexture(mIcons[index], NULL, NULL, &iconSize.w, &iconSize.h); // Get original icon dimensions
-
-    float widthRatio = static_cast<float>(drawableWidth) / iconSize.w;
-    float heightRatio = static_cast<float>(drawableHeight) / iconSize.h;
-    float scaleRatio = std::min(widthRatio, heightRatio); // Scale to fit within the drawable area
-
-    iconWidth = static_cast<int>(iconSize.w * scaleRatio);
-    renderIconHeight = static_cast<int>(iconSize.h * scaleRatio);
-
-    // Prepare the rectangle for rendering
-    SDL_Rect renderQuad;
-    renderQuad.w = iconWidth;
-    renderQuad.h = renderIconHeight;
-
-    // Center the icon horizontally within the drawable area
-    renderQuad.x = mReelRect.x + borderOffset + (drawableWidth - iconWidth) / 2;
-    // Position vertically based on yOffset
-    renderQuad.y = mReelRect.y + yOffset + borderOffset;
-
-    // Ensure rendering happens within frame bounds
-    mRenderer->renderTexture(mIcons[index], NULL, &renderQuad);
+SDL_Point Reel::getIconCellSize() const {
+    return { mReelRect.w - 2 * BORDER_OFFSET, mReelRect.h / mRows };
 }
 
 /**
- * Updates the position of the reel if it is spinning.
- * @param deltaTime The time elapsed since the last frame.
+ * Gets the height of the whole strip at the current cell size.
+ * @return The strip height in pixels, or the reel height if the strip is empty.
  */
-void Reel::update(Uint32 deltaTime) {
-    if (mSpinning) {
-        Uint32 currentTime = SDL_GetTicks();
-        Uint32 elapsed = currentTime - mSpinStartTime;
-
-        // Update position based on deltaTime and spin speed
-        mStartPosition = (mStartPosition - static_cast<int>(deltaTime * mSpinSpeed)) % mReelRect.h;
-
-        // Check if the reel should stop
-        if (elapsed >= mSpinDuration) {
-            if (currentTime >= mStopTime) {
-                mSpinning = false;
-                setRandomPosition(); // Optionally set a random position after stopping
-                printf("Reel stopped at position %d\n", mStartPosition);
-            }
-        }
+int Reel::getStripHeight() const {
+    if (mStrip.empty()) {
+        return mReelRect.h;
     }
+    return getIconCellSize().y * static_cast<int>(mStrip.size());
 }
 
 /**
- * Sets a random position for the reel.
+ * Computes where each stop's icon goes in the reel strip, once per atlas cell size.
+ * Each icon is fitted into its cell, centered horizontally and offset by the
+ * border; copies that cross the bottom edge are repeated at the top, and
+ * copies that fall entirely outside the strip are dropped.
  */
-void Reel::setRandomPosition() {
-    if (mIcons.empty()) return;
-    int iconCount = static_cast<int>(mIcons.size());
-    int iconHeight = mReelRect.h / iconCount;
-    int randomIndex = std::rand() % iconCount;
-    mStartPosition = randomIndex * iconHeight;
+void Reel::updateLayout() {
+    mLayoutTexture = mAtlas->getTexture();
+    mIconCells.clear();
+
+    int iconCount = mAtlas->getIconCount();
+    if (iconCount == 0) return;
+
+    SDL_Point cell = getIconCellSize();
+    int stripHeight = getStripHeight();
+    SDL_Rect stripRect = { 0, 0, mReelRect.w, stripHeight };
+    int stopCount = static_cast<int>(mStrip.size());
+    for (int wrap = -1; wrap <= 0; ++wrap) { // Second pass wraps icons crossing the bottom edge
+        for (int j = 0; j < stopCount; ++j) {
+            if (mStrip[j] < 0 || mStrip[j] >= iconCount) continue;
+
+            // Scale the icon to fit within the drawable area while maintaining aspect ratio
+            const SDL_Rect& iconSize = mAtlas->getIconRect(mStrip[j]); // Icon dimensions in the atlas
+            float widthRatio = static_cast<float>(cell.x) / iconSize.w;
+            float heightRatio = static_cast<float>(cell.y) / iconSize.h;
+            float scaleRatio = std::min(widthRatio, heightRatio);
+
+            IconCell iconCell;
+            iconCell.icon = mStrip[j];
+            iconCell.rect.w = static_cast<int>(iconSize.w * scaleRatio);
+            iconCell.rect.h = static_cast<int>(iconSize.h * scaleRatio);
+            iconCell.rect.x = BORDER_OFFSET + (cell.x - iconCell.rect.w) / 2;
+            iconCell.rect.y = wrap * stripHeight + j * cell.y + BORDER_OFFSET;
+            if (SDL_HasIntersection(&iconCell.rect, &stripRect)) {
+                mIconCells.push_back(iconCell);
+            }
+        }
+    }
 }
 
 /**
- * Sets the position of the reel.
- * @param position The new position of the reel.
+ * Renders the reel strip into its column of a shared render-target texture.
+ * The strip holds the background and the icon of every stop at the reel's
+ * cell size, with icons that cross the bottom edge wrapped to the top.
+ * Call again whenever the target is recreated or its contents are lost.
+ * @param stripTexture The render-target texture shared by all reels.
+ * @param stripX The x-coordinate of this reel's column in the texture.
  */
-void Reel::setPosition(int position) {
-    int totalHeight = mReelRect.h;
+void Reel::bakeStrip(SDL_Texture* stripTexture, int stripX) {
+    mStripTexture = stripTexture;
+    mStripX = stripX;
+    if (mStripTexture == nullptr) return;
 
-    // Normalize the position to ensure it wraps around properly
-    mStartPosition = position % totalHeight;
-    if (mStartPosition < 0) {
-        mStartPosition += totalHeight;
+    if (mLayoutTexture != mAtlas->getTexture()) {
+        updateLayout(); // The strip changed or the atlas was resampled for another cell size
     }
 
-    printf("Setting reel position to: %d\n", mStartPosition);
-}
+    SDL_Rect stripRect = { mStripX, 0, mReelRect.w, getStripHeight() };
 
-/**
- * Starts spinning the reel with a random speed and specified stop delay.
- * @param startOffset The initial offset for the start position.
- * @param stopDelay The delay before the reel stops.
- */
-void Reel::startSpin(int startOffset, Uint32 stopDelay) {
-    setRandomSpinSpeed();
-    mSpinning = true;
-    mSpinStartTime = SDL_GetTicks();
-    mStartPositionOffset = startOffset;
-    mStopDelay = stopDelay;
-    mStopTime = mSpinStartTime + mSpinDuration + stopDelay; // Calculate stop time
-}
+    mRenderer->setRenderTarget(mStripTexture);
+    mRenderer->beginBatch(mAtlas->getTexture());
 
-/**
- * Sets the stop time for the reel.
- * @param time The time at which the reel should stop.
- */
-void Reel::setStopTime(Uint32 time) {
-    mStopTime = time;
-}
+    SDL_Color black = { 0, 0, 0, 255 };
+    mRenderer->batchQuad(mAtlas->getSolidRect(), stripRect, black); // Fill the reel background
 
-/**
- * Checks if the reel should stop spinning.
- * @param currentTime The current time.
- * @return True if the reel should stop, false otherwise.
- */
-bool Reel::shouldStop(Uint32 currentTime) {
-    return currentTime >= mStopTime;
+    SDL_Color white = { 255, 255, 255, 255 };
+    for (const IconCell& iconCell : mIconCells) {
+        SDL_Rect dst = { mStripX + iconCell.rect.x, iconCell.rect.y, iconCell.rect.w, iconCell.rect.h };
+        mRenderer->batchQuad(mAtlas->getIconRect(iconCell.icon), dst, stripRect, white);
+    }
+
+    mRenderer->flushBatch();
+    mRenderer->setRenderTarget(nullptr);
 }
 
 /**
- * Stops the reel from spinning and sets a random position.
+ * Renders the part of the reel inside a screen region at its current position.
+ * The window is copied from the baked strip with at most two quads that wrap
+ * around mStartPosition; a quad outside the region is not emitted at all.
+ * The quads are added to the Renderer's current batch, which the caller starts
+ * with the strip texture and flushes after all reels.
+ * @param region The screen region being repainted.
  */
-void Reel::stopSpin() {
-    mSpinning = false;
-    setRandomPosition();
+void Reel::render(const SDL_Rect& region) {
+    PROFILE_ZONE("Reel::render");
+    if (mStripTexture == nullptr) return;
+
+    SDL_Rect visible;
+    if (!SDL_IntersectRect(&mClipRect, &region, &visible)) return;
+
+    // Strip row shown at the top of the reel; the window wraps past the end of the strip
+    int stripHeight = getStripHeight();
+    int offset = ((mStartPosition % stripHeight) + stripHeight) % stripHeight;
+    int topHeight = std::min(mReelRect.h, stripHeight - offset);
+
+    SDL_Color white = { 255, 255, 255, 255 };
+    SDL_Rect topDst = { mReelRect.x, mReelRect.y, mReelRect.w, topHeight };
+    if (SDL_HasIntersection(&topDst, &visible)) {
+        SDL_Rect topSrc = { mStripX, offset, mReelRect.w, topHeight };
+        mRenderer->batchQuad(topSrc, topDst, visible, white);
+    }
+
+    SDL_Rect wrapDst = { mReelRect.x, mReelRect.y + topHeight, mReelRect.w, mReelRect.h - topHeight };
+    if (SDL_HasIntersection(&wrapDst, &visible)) {
+        SDL_Rect wrapSrc = { mStripX, 0, mReelRect.w, mReelRect.h - topHeight };
+        mRenderer->batchQuad(wrapSrc, wrapDst, visible, white);
+    }
 }
 
 /**
- * Checks if the reel is currently spinning.
- * @return True if the reel is spinning, false otherwise.
+ * Sets the render position from a simulation snapshot, blended between the
+ * previous and the current step. Invalidates the reel if the visible position changed.
+ * @param state The reel state published by the simulation.
+ * @param alpha The interpolation factor in [0, 1].
  */
-bool Reel::isSpinning() const {
-    return mSpinning;
+void Reel::setState(const ReelState& state, float alpha) {
+    float position = state.previousPosition + (state.position - state.previousPosition) * alpha;
+    int renderPosition = static_cast<int>(std::floor(position));
+    if (renderPosition != mStartPosition) {
+        mStartPosition = renderPosition;
+        mRenderer->invalidate(mClipRect);
+    }
 }
 
 /**
- * Sets a random spin speed for the reel.
+ * Gets the on-screen rectangle of the reel.
+ * @return The reel rectangle.
  */
-void Reel::setRandomSpinSpeed() {
-    // Set a random spin speed between 0.5 and 2.0
-    mSpinSpeed = 0.5f + static_cast<float>(std::rand()) / (static_cast<float>(RAND_MAX / (0.5f - 0.1f)));
+const SDL_Rect& Reel::getRect() const {
+    return mReelRect;
 }
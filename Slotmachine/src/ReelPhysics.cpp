@@ -0,0 +1,131 @@
+#include "ReelPhysics.h"
+#include "Profiler.h"
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * Constructor for the ReelPhysics class.
+ * @param height The height of the reel strip in pixels; positions wrap at this value.
+ * @param iconCount The number of stops on the strip.
+ * @param random The random stream for this reel's spin speeds.
+ */
+ReelPhysics::ReelPhysics(int height, int iconCount, const Random& random)
+    : mState{ 0.0f, 0.0f, false }, mHeight(height), mIconCount(iconCount), mSpinElapsed(0.0f),
+    mSpinDuration(2000.0f), mStopDelay(0.0f), mSpinSpeed(1.0f), mSpinStart(0.0f), mSpinDistance(0.0f),
+    mTargetStop(0), mRandom(random) {}
+
+/**
+ * Starts spinning the reel toward a stop chosen in advance. The spin lasts
+ * exactly its duration plus the stop delay; the cruise speed is the random
+ * speed adjusted so that the whole turns plus the braking distance end on the stop.
+ * @param stopDelay The extra time in milliseconds the reel spins before stopping.
+ * @param targetStop The strip index to show in the top row when the reel stops.
+ */
+void ReelPhysics::startSpin(float stopDelay, int targetStop) {
+    setRandomSpinSpeed();
+    mState.spinning = true;
+    mSpinElapsed = 0.0f;
+    mStopDelay = stopDelay;
+    mTargetStop = targetStop;
+    mSpinStart = mState.position;
+
+    if (mHeight <= 0 || mIconCount <= 0) {
+        mSpinDistance = 0.0f;
+        return;
+    }
+
+    // Braking at a constant rate covers half the distance cruising would
+    float height = static_cast<float>(mHeight);
+    float cruiseEquivalentMs = mSpinDuration + mStopDelay - BRAKE_MS / 2.0f;
+    float target = static_cast<float>(targetStop * (mHeight / mIconCount));
+    float remainder = std::fmod(mSpinStart - target, height);
+    if (remainder < 0.0f) {
+        remainder += height;
+    }
+    float turns = std::max(1.0f, std::round((mSpinSpeed * cruiseEquivalentMs - remainder) / height));
+    mSpinDistance = remainder + turns * height;
+    mSpinSpeed = mSpinDistance / cruiseEquivalentMs;
+}
+
+/**
+ * Computes how far the reel has moved since the spin started: constant speed
+ * until the last BRAKE_MS, then constant deceleration to rest.
+ * @return The distance in pixels.
+ */
+float ReelPhysics::getDistanceTravelled() const {
+    float total = mSpinDuration + mStopDelay;
+    float cruise = total - BRAKE_MS;
+    if (mSpinElapsed >= total) {
+        return mSpinDistance;
+    }
+    if (mSpinElapsed <= cruise) {
+        return mSpinSpeed * mSpinElapsed;
+    }
+    float braking = mSpinElapsed - cruise;
+    return mSpinSpeed * (mSpinElapsed - braking * braking / (2.0f * BRAKE_MS));
+}
+
+/**
+ * Advances the reel by one fixed simulation step if it is spinning.
+ * @param stepMs The simulation step in milliseconds.
+ */
+void ReelPhysics::update(float stepMs) {
+    PROFILE_ZONE("ReelPhysics::update");
+    if (!mState.spinning) {
+        return;
+    }
+    mSpinElapsed += stepMs;
+
+    if (mSpinElapsed >= mSpinDuration + mStopDelay) {
+        mState.spinning = false;
+        setPosition(mTargetStop * (mIconCount > 0 ? mHeight / mIconCount : 0));
+        printf("Reel stopped at stop %d\n", mTargetStop);
+        return;
+    }
+
+    // The previous position is wrapped together with the current one so interpolation stays continuous
+    float height = static_cast<float>(mHeight);
+    float position = std::fmod(mSpinStart - getDistanceTravelled(), height);
+    if (position < 0.0f) {
+        position += height;
+    }
+    mState.previousPosition = mState.position;
+    if (position > mState.position) {
+        mState.previousPosition += height;
+    }
+    mState.position = position;
+}
+
+/**
+ * Sets the position of the reel, wrapped to the strip height.
+ * @param position The new position of the reel.
+ */
+void ReelPhysics::setPosition(int position) {
+    int wrapped = mHeight > 0 ? ((position % mHeight) + mHeight) % mHeight : 0;
+    mState.position = mState.previousPosition = static_cast<float>(wrapped);
+}
+
+/**
+ * Checks if the reel is currently spinning.
+ * @return True if the reel is spinning, false otherwise.
+ */
+bool ReelPhysics::isSpinning() const {
+    return mState.spinning;
+}
+
+/**
+ * Gets the state to publish in the next snapshot.
+ * @return The reel state.
+ */
+const ReelState& ReelPhysics::getState() const {
+    return mState;
+}
+
+/**
+ * Sets a random spin speed for the reel.
+ */
+void ReelPhysics::setRandomSpinSpeed() {
+    // Set a random spin speed between 1.0 and 1.8 pixels per millisecond
+    mSpinSpeed = mRandom.nextFloat(1.0f, 1.8f);
+}
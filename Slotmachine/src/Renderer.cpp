@@ -1,17 +1,31 @@
 #include "Renderer.h"
+#include "Subsystems.h"
+#include "Profiler.h"
 #include <stdexcept>
 #include <iostream>
 
+int RenderStats::getDrawCalls() const {
+    return clears + copies + geometryBatches + fillRects + lines;
+}
+
+int RenderStats::getStateChanges() const {
+    return drawColorChanges + clipRectChanges + targetChanges + textureSwitches + textureModChanges;
+}
+
 Renderer::Renderer(int screenWidth, int screenHeight)
-    : mScreenWidth(screenWidth), mScreenHeight(screenHeight), mWindow(nullptr), mRenderer(nullptr) {}
+    : mScreenWidth(screenWidth), mScreenHeight(screenHeight), mWindow(nullptr), mRenderer(nullptr),
+    mBatchTexture(nullptr), mBatchTextureWidth(1.0f), mBatchTextureHeight(1.0f),
+    mCanvas(nullptr), mInFrame(false), mRepaintPercent(0.0f), mRepaintPercentSum(0.0), mRepaintFrames(0),
+    mCurrentStats(), mFrameStats(), mLastDrawTexture(nullptr),
+    mDrawColor{ 0, 0, 0, 0 }, mDrawColorKnown(false),
+    mClipRect{ 0, 0, 0, 0 }, mClipEnabled(false), mClipKnown(false), mRenderTarget(nullptr), mRenderTargetKnown(false) {}
 
 Renderer::~Renderer() {
     cleanup();
 }
 
 bool Renderer::init(const std::string& windowTitle) {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
+    if (!Subsystems::ensureVideo()) {
         return false;
     }
 
@@ -21,51 +35,122 @@ bool Renderer::init(const std::string& windowTitle) {
         return false;
     }
 
-    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED);
+    mRenderer = SDL_CreateRenderer(mWindow, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE);
     if (!mRenderer) {
         std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
 
-    if (!(IMG_Init(IMG_INIT_PNG) & IMG_INIT_PNG)) {
-        std::cerr << "SDL_image could not initialize! IMG_Error: " << IMG_GetError() << std::endl;
-        return false;
-    }
+    return true;
+}
 
-    if (TTF_Init() == -1) {
-        std::cerr << "SDL_ttf could not initialize! TTF_Error: " << TTF_GetError() << std::endl;
+bool Renderer::setVSync(bool enabled) {
+    if (SDL_RenderSetVSync(mRenderer, enabled ? 1 : 0) != 0) {
+        std::cerr << "Unable to change vsync! SDL_Error: " << SDL_GetError() << std::endl;
         return false;
     }
-
     return true;
 }
 
 void Renderer::clearScreen(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
-    SDL_SetRenderDrawColor(mRenderer, r, g, b, a);
+    setDrawColor(r, g, b, a);
     SDL_RenderClear(mRenderer);
+    mCurrentStats.clears++;
 }
 
 void Renderer::present() {
+    PROFILE_ZONE("Renderer::present");
     SDL_RenderPresent(mRenderer);
+    mCurrentStats.presents++;
 }
 
 SDL_Texture* Renderer::loadTexture(const std::string& filePath) {
-    SDL_Texture* texture = nullptr;
+    if (!Subsystems::ensureImage()) {
+        return nullptr;
+    }
     SDL_Surface* loadedSurface = IMG_Load(filePath.c_str());
     if (!loadedSurface) {
         std::cerr << "Unable to load image! SDL_image Error: " << IMG_GetError() << std::endl;
         return nullptr;
     }
-    texture = SDL_CreateTextureFromSurface(mRenderer, loadedSurface);
+    SDL_Texture* texture = createTexture(loadedSurface);
     SDL_FreeSurface(loadedSurface);
+    return texture;
+}
+
+SDL_Texture* Renderer::createTexture(SDL_Surface* surface) {
+    SDL_Texture* texture = SDL_CreateTextureFromSurface(mRenderer, surface);
     if (!texture) {
         std::cerr << "Unable to create texture! SDL Error: " << SDL_GetError() << std::endl;
     }
     return texture;
 }
 
+SDL_Texture* Renderer::createStaticTexture(Uint32 format, int width, int height, const void* pixels, int pitch) {
+    SDL_Texture* texture = SDL_CreateTexture(mRenderer, format, SDL_TEXTUREACCESS_STATIC, width, height);
+    if (!texture) {
+        std::cerr << "Unable to create texture! SDL Error: " << SDL_GetError() << std::endl;
+        return nullptr;
+    }
+    if (SDL_UpdateTexture(texture, nullptr, pixels, pitch) != 0) {
+        std::cerr << "Unable to upload texture! SDL Error: " << SDL_GetError() << std::endl;
+        SDL_DestroyTexture(texture);
+        return nullptr;
+    }
+    return texture;
+}
+
+bool Renderer::setPremultipliedBlendMode(SDL_Texture* texture) {
+    static const SDL_BlendMode premultiplied = SDL_ComposeCustomBlendMode(
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD,
+        SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+    if (SDL_SetTextureBlendMode(texture, premultiplied) != 0) {
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+        return false;
+    }
+    return true;
+}
+
+void Renderer::setTextureColorMod(SDL_Texture* texture, SDL_Color color) {
+    // The texture keeps its own mods, so they are compared with what it holds
+    Uint8 r, g, b, a;
+    if (SDL_GetTextureColorMod(texture, &r, &g, &b) == 0 && r == color.r && g == color.g && b == color.b) {
+        mCurrentStats.skippedStateChanges++;
+    }
+    else {
+        SDL_SetTextureColorMod(texture, color.r, color.g, color.b);
+        mCurrentStats.textureModChanges++;
+    }
+    if (SDL_GetTextureAlphaMod(texture, &a) == 0 && a == color.a) {
+        mCurrentStats.skippedStateChanges++;
+    }
+    else {
+        SDL_SetTextureAlphaMod(texture, color.a);
+        mCurrentStats.textureModChanges++;
+    }
+}
+
+void Renderer::setTextureBlendMode(SDL_Texture* texture, SDL_BlendMode blendMode) {
+    SDL_BlendMode current;
+    if (SDL_GetTextureBlendMode(texture, &current) == 0 && current == blendMode) {
+        mCurrentStats.skippedStateChanges++;
+        return;
+    }
+    SDL_SetTextureBlendMode(texture, blendMode);
+    mCurrentStats.textureModChanges++;
+}
+
+void Renderer::countTexture(SDL_Texture* texture) {
+    if (texture != mLastDrawTexture) {
+        mCurrentStats.textureSwitches++;
+        mLastDrawTexture = texture;
+    }
+}
+
 void Renderer::renderTexture(SDL_Texture* texture, const SDL_Rect* srcRect, const SDL_Rect* destRect) {
     SDL_RenderCopy(mRenderer, texture, srcRect, destRect);
+    countTexture(texture);
+    mCurrentStats.copies++;
 }
 
 SDL_Texture* Renderer::renderText(const std::string& text, TTF_Font* font, SDL_Color color) {
@@ -83,22 +168,274 @@ SDL_Texture* Renderer::renderText(const std::string& text, TTF_Font* font, SDL_C
 }
 
 void Renderer::setDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+    if (mDrawColorKnown && mDrawColor.r == r && mDrawColor.g == g && mDrawColor.b == b && mDrawColor.a == a) {
+        mCurrentStats.skippedStateChanges++;
+        return;
+    }
     SDL_SetRenderDrawColor(mRenderer, r, g, b, a); // Set the color for drawing operations
+    mDrawColor = { r, g, b, a };
+    mDrawColorKnown = true;
+    mCurrentStats.drawColorChanges++;
 }
 
 void Renderer::fillRect(const SDL_Rect& rect) {
 	SDL_RenderFillRect(mRenderer, &rect); // Fill the rectangle with the current draw color
+    mCurrentStats.fillRects++;
 }
 
 void Renderer::drawLine(int x1, int y1, int x2, int y2) {
     SDL_RenderDrawLine(mRenderer, x1, y1, x2, y2);
+    mCurrentStats.lines++;
+}
+
+SDL_Texture* Renderer::createTargetTexture(int width, int height) {
+    SDL_Texture* texture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_TARGET, width, height);
+    if (!texture) {
+        std::cerr << "Unable to create render target! SDL_Error: " << SDL_GetError() << std::endl;
+    }
+    return texture;
 }
 
-SDL_Renderer* Renderer::getSDLRenderer() const {
-    return mRenderer;
+SDL_Texture* Renderer::createStreamingTexture(int width, int height) {
+    SDL_Texture* texture = SDL_CreateTexture(mRenderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!texture) {
+        std::cerr << "Unable to create streaming texture! SDL_Error: " << SDL_GetError() << std::endl;
+    }
+    return texture;
+}
+
+bool Renderer::updateTexture(SDL_Texture* texture, const SDL_Rect* rect, const void* pixels, int pitch) {
+    flushBatch(); // Quads already batched must still show the old pixels
+    if (SDL_UpdateTexture(texture, rect, pixels, pitch) != 0) {
+        std::cerr << "Unable to update texture! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+    mCurrentStats.textureUploads++;
+    return true;
+}
+
+void Renderer::setRenderTarget(SDL_Texture* texture) {
+    flushBatch();
+    if (mRenderTargetKnown && mRenderTarget == texture) {
+        mCurrentStats.skippedStateChanges++;
+        return;
+    }
+    if (SDL_SetRenderTarget(mRenderer, texture) != 0) {
+        std::cerr << "Unable to set render target! SDL_Error: " << SDL_GetError() << std::endl;
+        mRenderTargetKnown = false;
+    }
+    else {
+        mRenderTarget = texture;
+        mRenderTargetKnown = true;
+    }
+    mClipKnown = false; // SDL swaps the clip rect with the target
+    mCurrentStats.targetChanges++;
+}
+
+void Renderer::beginBatch(SDL_Texture* texture) {
+    if (mBatchTexture != nullptr && mBatchTexture != texture) {
+        flushBatch();
+    }
+    mBatchTexture = texture;
+
+    int w = 1;
+    int h = 1;
+    if (texture != nullptr) {
+        SDL_QueryTexture(texture, nullptr, nullptr, &w, &h);
+    }
+    mBatchTextureWidth = static_cast<float>(w);
+    mBatchTextureHeight = static_cast<float>(h);
+}
+
+void Renderer::batchQuad(const SDL_Rect& srcRect, const SDL_Rect& destRect, SDL_Color color) {
+    batchQuad(srcRect, destRect, destRect, color);
+}
+
+void Renderer::batchQuad(const SDL_Rect& srcRect, const SDL_Rect& destRect, const SDL_Rect& clipRect, SDL_Color color) {
+    SDL_Rect visible;
+    if (destRect.w <= 0 || destRect.h <= 0 || !SDL_IntersectRect(&destRect, &clipRect, &visible)) {
+        return;
+    }
+
+    // Shrink the source rectangle by the same proportion the destination was clipped
+    float scaleX = static_cast<float>(srcRect.w) / destRect.w;
+    float scaleY = static_cast<float>(srcRect.h) / destRect.h;
+    float u0 = (srcRect.x + (visible.x - destRect.x) * scaleX) / mBatchTextureWidth;
+    float v0 = (srcRect.y + (visible.y - destRect.y) * scaleY) / mBatchTextureHeight;
+    float u1 = (srcRect.x + (visible.x + visible.w - destRect.x) * scaleX) / mBatchTextureWidth;
+    float v1 = (srcRect.y + (visible.y + visible.h - destRect.y) * scaleY) / mBatchTextureHeight;
+
+    float x0 = static_cast<float>(visible.x);
+    float y0 = static_cast<float>(visible.y);
+    float x1 = static_cast<float>(visible.x + visible.w);
+    float y1 = static_cast<float>(visible.y + visible.h);
+
+    int base = static_cast<int>(mBatchVertices.size());
+    mBatchVertices.push_back({ { x0, y0 }, color, { u0, v0 } });
+    mBatchVertices.push_back({ { x1, y0 }, color, { u1, v0 } });
+    mBatchVertices.push_back({ { x1, y1 }, color, { u1, v1 } });
+    mBatchVertices.push_back({ { x0, y1 }, color, { u0, v1 } });
+
+    const int quadIndices[6] = { 0, 1, 2, 0, 2, 3 };
+    for (int index : quadIndices) {
+        mBatchIndices.push_back(base + index);
+    }
+}
+
+void Renderer::flushBatch() {
+    if (!mBatchIndices.empty()) {
+        if (SDL_RenderGeometry(mRenderer, mBatchTexture, mBatchVertices.data(), static_cast<int>(mBatchVertices.size()),
+            mBatchIndices.data(), static_cast<int>(mBatchIndices.size())) != 0) {
+            std::cerr << "Unable to render geometry batch! SDL_Error: " << SDL_GetError() << std::endl;
+        }
+        countTexture(mBatchTexture);
+        mCurrentStats.geometryBatches++;
+        mCurrentStats.batchedQuads += static_cast<int>(mBatchIndices.size() / 6);
+    }
+    mBatchVertices.clear();
+    mBatchIndices.clear();
+    mBatchTexture = nullptr;
+}
+
+void Renderer::setClipRect(const SDL_Rect* rect) {
+    bool enabled = rect != nullptr;
+    if (mClipKnown && enabled == mClipEnabled && (!enabled || SDL_RectEquals(rect, &mClipRect))) {
+        mCurrentStats.skippedStateChanges++;
+        return;
+    }
+    flushBatch();
+    SDL_RenderSetClipRect(mRenderer, rect);
+    mClipEnabled = enabled;
+    if (enabled) {
+        mClipRect = *rect;
+    }
+    mClipKnown = true;
+    mCurrentStats.clipRectChanges++;
+}
+
+void Renderer::invalidate(const SDL_Rect& rect) {
+    SDL_Rect screen = { 0, 0, mScreenWidth, mScreenHeight };
+    SDL_Rect region;
+    if (!SDL_IntersectRect(&rect, &screen, &region)) {
+        return;
+    }
+
+    // Regions invalidated while a frame is being drawn are repainted in the next one
+    std::vector<SDL_Rect>& regions = mInFrame ? mPendingRegions : mDirtyRegions;
+
+    // Merge with every region it overlaps or touches until nothing changes
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < regions.size(); ++i) {
+            const SDL_Rect& other = regions[i];
+            if (region.x <= other.x + other.w && other.x <= region.x + region.w &&
+                region.y <= other.y + other.h && other.y <= region.y + region.h) {
+                SDL_UnionRect(&region, &other, &region);
+                regions.erase(regions.begin() + i);
+                merged = true;
+                break;
+            }
+        }
+    }
+    regions.push_back(region);
+
+    // Too many separate regions cost more draw calls than they save in fill rate
+    if (regions.size() > MAX_DIRTY_REGIONS) {
+        SDL_Rect bounds = regions[0];
+        for (const SDL_Rect& other : regions) {
+            SDL_UnionRect(&bounds, &other, &bounds);
+        }
+        regions.clear();
+        regions.push_back(bounds);
+    }
+}
+
+void Renderer::invalidateAll() {
+    std::vector<SDL_Rect>& regions = mInFrame ? mPendingRegions : mDirtyRegions;
+    regions.clear();
+    regions.push_back({ 0, 0, mScreenWidth, mScreenHeight });
+}
+
+bool Renderer::hasDirtyRegions() const {
+    return !mDirtyRegions.empty();
+}
+
+bool Renderer::beginFrame() {
+    mRepaintFrames++;
+    if (mCanvas == nullptr) {
+        mCanvas = createTargetTexture(mScreenWidth, mScreenHeight);
+        if (mCanvas != nullptr) {
+            setTextureBlendMode(mCanvas, SDL_BLENDMODE_NONE);
+        }
+        invalidateAll();
+    }
+
+    if (mDirtyRegions.empty()) {
+        mRepaintPercent = 0.0f;
+        return false;
+    }
+
+    if (mCanvas != nullptr) {
+        setRenderTarget(mCanvas);
+    }
+    else {
+        invalidateAll(); // Without a canvas every frame is drawn from scratch
+    }
+    mInFrame = true;
+    return true;
+}
+
+const std::vector<SDL_Rect>& Renderer::getDirtyRegions() const {
+    return mDirtyRegions;
+}
+
+void Renderer::endFrame() {
+    PROFILE_ZONE("Renderer::endFrame");
+    setClipRect(nullptr);
+    if (mCanvas != nullptr) {
+        setRenderTarget(nullptr);
+        renderTexture(mCanvas, nullptr, nullptr);
+    }
+    present();
+
+    long long pixels = 0;
+    for (const SDL_Rect& region : mDirtyRegions) {
+        pixels += static_cast<long long>(region.w) * region.h;
+    }
+    mRepaintPercent = 100.0f * pixels / (static_cast<float>(mScreenWidth) * mScreenHeight);
+    mRepaintPercentSum += mRepaintPercent;
+
+    mInFrame = false;
+    mDirtyRegions.swap(mPendingRegions);
+    mPendingRegions.clear();
+
+    mFrameStats = mCurrentStats;
+    mCurrentStats = RenderStats();
+}
+
+float Renderer::getRepaintPercent() const {
+    return mRepaintPercent;
+}
+
+float Renderer::getAverageRepaintPercent() const {
+    return mRepaintFrames > 0 ? static_cast<float>(mRepaintPercentSum / mRepaintFrames) : 0.0f;
+}
+
+void Renderer::resetRepaintStats() {
+    mRepaintPercentSum = 0.0;
+    mRepaintFrames = 0;
+}
+
+const RenderStats& Renderer::getFrameStats() const {
+    return mFrameStats;
 }
 
 void Renderer::cleanup() {
+    if (mCanvas) {
+        SDL_DestroyTexture(mCanvas);
+        mCanvas = nullptr;
+    }
     if (mRenderer) {
         SDL_DestroyRenderer(mRenderer);
         mRenderer = nullptr;
@@ -107,7 +444,4 @@ void Renderer::cleanup() {
         SDL_DestroyWindow(mWindow);
         mWindow = nullptr;
     }
-    IMG_Quit();
-    TTF_Quit();
-    SDL_Quit();
 }
@@ -0,0 +1,225 @@
+#include "Simulation.h"
+#include "Profiler.h"
+#include <stdio.h>
+#include <cmath>
+#include <system_error>
+#include <algorithm>
+
+/**
+ * Constructor for the Simulation class.
+ * The thread wakes once per step while reels are spinning and sleeps otherwise.
+ * @param stepMs The fixed simulation step in milliseconds.
+ * @param seed The random seed for the spins.
+ */
+Simulation::Simulation(double stepMs, uint64_t seed)
+    : mRandom(seed), mScheduler(stepMs, static_cast<int>(std::lround(1000.0 / stepMs))), mStepMs(stepMs),
+    mStepTicks(static_cast<Uint64>(stepMs * SDL_GetPerformanceFrequency() / 1000.0)),
+    mRunning(false), mRequestedSpins(0), mStartedSpins(0), mRequestedStops{} {
+    mScheduler.setVSync(false);
+    publish();
+}
+
+/**
+ * Destructor for the Simulation class.
+ * Stops the simulation thread if it is running.
+ */
+Simulation::~Simulation() {
+    stop();
+}
+
+/**
+ * Adds a reel to the simulation.
+ * @param stripHeight The height of the whole reel strip in pixels.
+ * @param stopCount The number of stops on the strip.
+ * @return True if the reel was added, false if the simulation is running or full.
+ */
+bool Simulation::addReel(int stripHeight, int stopCount) {
+    if (mRunning) {
+        printf("Cannot add a reel while the simulation is running!\n");
+        return false;
+    }
+    if (mReels.size() >= GameSnapshot::MAX_REELS) {
+        printf("Cannot simulate more than %d reels!\n", static_cast<int>(GameSnapshot::MAX_REELS));
+        return false;
+    }
+    mReels.push_back(ReelPhysics(stripHeight, stopCount, mRandom.split()));
+    publish();
+    return true;
+}
+
+/**
+ * Starts the simulation thread.
+ * @return True if the thread was started, false otherwise.
+ */
+bool Simulation::start() {
+    if (mRunning) {
+        return true;
+    }
+    mRunning = true;
+    try {
+        mThread = std::thread(&Simulation::threadMain, this);
+    }
+    catch (const std::system_error& e) {
+        printf("Simulation thread could not be started! Error: %s\n", e.what());
+        mRunning = false;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Stops the simulation thread and waits for it to finish.
+ */
+void Simulation::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mRunning = false;
+    }
+    mWake.notify_one();
+    if (mThread.joinable()) {
+        mThread.join();
+    }
+}
+
+/**
+ * Asks the simulation to spin all reels. Ignored while a spin is in progress.
+ * The outcome is decided by the caller; the reels only animate toward it.
+ * @param stops The strip index each reel stops on, shown in its top row.
+ * @param count The number of entries in stops; missing reels stop on index 0.
+ * @return The spin number; the spin has started once a snapshot's spinCount reaches it.
+ */
+Uint32 Simulation::requestSpin(const int* stops, int count) {
+    Uint32 spin;
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        for (int i = 0; i < GameSnapshot::MAX_REELS; ++i) {
+            mRequestedStops[i] = i < count ? stops[i] : 0;
+        }
+        spin = ++mRequestedSpins;
+    }
+    mWake.notify_one();
+    return spin;
+}
+
+/**
+ * Gets the most recent snapshot published by the simulation thread.
+ * Only call from the render thread.
+ * @return The snapshot, valid until the next call.
+ */
+const GameSnapshot& Simulation::acquireSnapshot() {
+    return mSnapshots.acquire();
+}
+
+/**
+ * Computes how far the simulation has advanced past the snapshot, so the
+ * renderer can blend between its previous and current reel positions.
+ * @param snapshot The snapshot being rendered.
+ * @param now The performance counter value of the frame being rendered.
+ * @return The interpolation factor in [0, 1].
+ */
+float Simulation::getInterpolation(const GameSnapshot& snapshot, Uint64 now) const {
+    if (!snapshot.spinning || mStepTicks == 0) {
+        return 1.0f;
+    }
+    if (now <= snapshot.stepTime) {
+        return 0.0f; // Published after the frame clock was sampled
+    }
+    Uint64 elapsed = now - snapshot.stepTime;
+    return elapsed >= mStepTicks ? 1.0f : static_cast<float>(elapsed) / mStepTicks;
+}
+
+/**
+ * Simulation thread entry point. Steps the reels at a fixed rate while any
+ * of them spin and blocks until the next spin request otherwise.
+ */
+void Simulation::threadMain() {
+    Profiler::setThreadName("simulation");
+    mScheduler.reset();
+
+    while (mRunning) {
+        if (isIdle()) {
+            std::unique_lock<std::mutex> lock(mWakeMutex);
+            mWake.wait(lock, [this]() { return !mRunning || mRequestedSpins != mStartedSpins; });
+            lock.unlock();
+            mScheduler.reset(); // Do not replay the idle time as steps
+        }
+
+        mScheduler.beginFrame();
+
+        bool changed = false;
+        if (mRequestedSpins != mStartedSpins) {
+            startSpin();
+            changed = true;
+        }
+
+        float stepMs = static_cast<float>(mStepMs);
+        while (mScheduler.stepSimulation()) {
+            PROFILE_ZONE("Simulation::step");
+            for (ReelPhysics& reel : mReels) {
+                reel.update(stepMs);
+            }
+            changed = true;
+        }
+
+        if (changed) {
+            publish();
+        }
+        mScheduler.endFrame(false);
+    }
+}
+
+/**
+ * Checks if there is nothing to simulate until the next spin request.
+ * @return True if no reel is spinning and no spin is pending.
+ */
+bool Simulation::isIdle() const {
+    if (mRequestedSpins != mStartedSpins) {
+        return false;
+    }
+    for (const ReelPhysics& reel : mReels) {
+        if (reel.isSpinning()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Starts all reels toward the requested stops with staggered stop delays,
+ * unless they are already spinning.
+ */
+void Simulation::startSpin() {
+    int stops[GameSnapshot::MAX_REELS];
+    {
+        std::lock_guard<std::mutex> lock(mWakeMutex);
+        mStartedSpins = mRequestedSpins;
+        std::copy(mRequestedStops, mRequestedStops + GameSnapshot::MAX_REELS, stops);
+    }
+    for (const ReelPhysics& reel : mReels) {
+        if (reel.isSpinning()) {
+            return;
+        }
+    }
+
+    float stopDelay = 0.0f;
+    for (size_t i = 0; i < mReels.size(); ++i) {
+        mReels[i].startSpin(stopDelay, stops[i]);
+        stopDelay += 500.0f; // Reels stop one after another from left to right
+    }
+}
+
+/**
+ * Copies the reel states into a snapshot and hands it to the render thread.
+ */
+void Simulation::publish() {
+    GameSnapshot& snapshot = mSnapshots.back();
+    snapshot.reelCount = static_cast<int>(mReels.size());
+    snapshot.spinning = false;
+    for (int i = 0; i < snapshot.reelCount; ++i) {
+        snapshot.reels[i] = mReels[i].getState();
+        snapshot.spinning = snapshot.spinning || snapshot.reels[i].spinning;
+    }
+    snapshot.spinCount = mStartedSpins;
+    snapshot.stepTime = SDL_GetPerformanceCounter();
+    mSnapshots.publish();
+}
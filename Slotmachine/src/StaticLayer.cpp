@@ -0,0 +1,93 @@
+#include "StaticLayer.h"
+#include <stdio.h>
+
+/**
+ * Constructor for the StaticLayer class.
+ * @param renderer The custom Renderer to use for rendering.
+ * @param assets The AssetCache that owns the layer texture.
+ * @param width The width of the layer in pixels.
+ * @param height The height of the layer in pixels.
+ */
+StaticLayer::StaticLayer(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets, int width, int height)
+    : mRenderer(renderer), mAssets(assets), mWidth(width), mHeight(height), mDirty(true), mAvailable(true) {}
+
+/**
+ * Destructor for the StaticLayer class.
+ * The texture is released with the last handle to it.
+ */
+StaticLayer::~StaticLayer() {}
+
+/**
+ * Marks the cached image as stale so the next composite re-renders it.
+ */
+void StaticLayer::invalidate() {
+    mDirty = true;
+}
+
+/**
+ * Checks if the cached image needs to be re-rendered.
+ * @return True if the layer is dirty, false otherwise.
+ */
+bool StaticLayer::isDirty() const {
+    return mDirty;
+}
+
+/**
+ * Renders the layer into its target texture if it is dirty.
+ * The texture is created on first use, and the whole screen is marked for repaint.
+ * If the texture cannot be created, the failure is reported once and the
+ * caller draws the static elements directly from then on.
+ * @param drawLayer Draws the static elements; called with the layer as render target.
+ * @return True if the cached image is valid, false if the target could not be created.
+ */
+bool StaticLayer::composite(const std::function<void()>& drawLayer) {
+    if (!mDirty) {
+        return mAvailable;
+    }
+
+    if (!mTexture && mAvailable) {
+        SDL_Texture* texture = mRenderer->createTargetTexture(mWidth, mHeight);
+        if (texture == nullptr) {
+            printf("Unable to create static layer!\n");
+            mAvailable = false;
+        }
+        else {
+            mRenderer->setTextureBlendMode(texture, SDL_BLENDMODE_NONE); // The layer is opaque and covers the screen
+            mTexture = mAssets->adoptTexture("target:static-layer", texture);
+        }
+    }
+    if (!mAvailable) {
+        // Drawing directly repaints the static elements with every dirty region
+        mDirty = false;
+        mRenderer->invalidateAll();
+        return false;
+    }
+
+    mRenderer->setRenderTarget(mTexture.get());
+    mRenderer->clearScreen(0, 0, 0, 255);
+    drawLayer();
+    mRenderer->setRenderTarget(nullptr);
+
+    mDirty = false;
+    mRenderer->invalidateAll();
+    return true;
+}
+
+/**
+ * Copies the cached image to the current render target.
+ */
+void StaticLayer::render() {
+    if (mTexture) {
+        mRenderer->renderTexture(mTexture.get(), nullptr, nullptr);
+    }
+}
+
+/**
+ * Copies one region of the cached image to the same place on the current render target.
+ * @param region The region to copy.
+ */
+void StaticLayer::render(const SDL_Rect& region) {
+    if (mTexture) {
+        mRenderer->renderTexture(mTexture.get(), &region, &region);
+    }
+}
@@ -0,0 +1,149 @@
+#include "Subsystems.h"
+#include <SDL_image.h>
+#include <SDL_ttf.h>
+#include <SDL_mixer.h>
+#include <stdio.h>
+#include <algorithm>
+
+bool Subsystems::sVideo = false;
+bool Subsystems::sImage = false;
+bool Subsystems::sFonts = false;
+bool Subsystems::sAudio = false;
+std::vector<Subsystems::Phase> Subsystems::sPhases;
+
+/**
+ * Starts the SDL video subsystem.
+ * @return True if video is available, false otherwise.
+ */
+bool Subsystems::ensureVideo() {
+    if (sVideo) {
+        return true;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (SDL_InitSubSystem(SDL_INIT_VIDEO) < 0) {
+        printf("SDL video could not initialize! SDL_Error: %s\n", SDL_GetError());
+        return false;
+    }
+    sVideo = true;
+    addPhase("SDL video", start);
+    return true;
+}
+
+/**
+ * Starts the SDL_image decoders used by the game.
+ * @return True if at least one of the PNG and JPEG decoders is available, false otherwise.
+ */
+bool Subsystems::ensureImage() {
+    if (sImage) {
+        return true;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    int flags = IMG_INIT_JPG | IMG_INIT_PNG;
+    int initialized = IMG_Init(flags) & flags;
+    if (initialized == 0) {
+        printf("SDL_image could not initialize! IMG_Error: %s\n", IMG_GetError());
+        return false;
+    }
+    if (initialized != flags) {
+        printf("Some SDL_image decoders are unavailable! IMG_Error: %s\n", IMG_GetError());
+    }
+    sImage = true;
+    addPhase("SDL_image", start);
+    return true;
+}
+
+/**
+ * Starts SDL_ttf.
+ * @return True if fonts can be opened, false otherwise.
+ */
+bool Subsystems::ensureFonts() {
+    if (sFonts) {
+        return true;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (TTF_Init() == -1) {
+        printf("SDL_ttf could not initialize! SDL_ttf Error: %s\n", TTF_GetError());
+        return false;
+    }
+    sFonts = true;
+    addPhase("SDL_ttf", start);
+    return true;
+}
+
+/**
+ * Starts the SDL audio subsystem and opens the mixer.
+ * @return True if sounds can be loaded and played, false otherwise.
+ */
+bool Subsystems::ensureAudio() {
+    if (sAudio) {
+        return true;
+    }
+    Uint64 start = SDL_GetPerformanceCounter();
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) < 0) {
+        printf("SDL audio could not initialize! SDL_Error: %s\n", SDL_GetError());
+        return false;
+    }
+    if (Mix_Init(MIX_INIT_MP3) == 0) {
+        printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
+    }
+    // The AssetPacker tool decodes sounds with the same format
+    if (Mix_OpenAudio(MIX_DEFAULT_FREQUENCY, MIX_DEFAULT_FORMAT, MIX_DEFAULT_CHANNELS, 4096) != 0) {
+        printf("SDL_mixer could not initialize! SDL_mixer Error: %s\n", Mix_GetError());
+        Mix_Quit();
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    sAudio = true;
+    addPhase("SDL audio + mixer", start);
+    return true;
+}
+
+/**
+ * Records how long a startup phase took.
+ * @param name The name of the phase; must be a string literal.
+ * @param startCounter The performance counter value when the phase began.
+ */
+void Subsystems::addPhase(const char* name, Uint64 startCounter) {
+    sPhases.push_back({ name, startCounter, SDL_GetPerformanceCounter() });
+}
+
+/**
+ * Prints the duration of every recorded startup phase.
+ */
+void Subsystems::printStartupReport() {
+    if (sPhases.empty()) {
+        return;
+    }
+    double msPerTick = 1000.0 / SDL_GetPerformanceFrequency();
+    Uint64 first = sPhases[0].start;
+    Uint64 last = sPhases[0].end;
+    printf("Startup phases:\n");
+    for (const Phase& phase : sPhases) {
+        printf("  %-20s %8.1f ms\n", phase.name, (phase.end - phase.start) * msPerTick);
+        first = std::min(first, phase.start);
+        last = std::max(last, phase.end);
+    }
+    printf("  %-20s %8.1f ms\n", "total", (last - first) * msPerTick);
+}
+
+/**
+ * Shuts down every started library in reverse order of dependency.
+ * Everything created with them must already be released.
+ */
+void Subsystems::shutdown() {
+    if (sAudio) {
+        Mix_CloseAudio();
+        Mix_Quit();
+        sAudio = false;
+    }
+    if (sFonts) {
+        TTF_Quit();
+        sFonts = false;
+    }
+    if (sImage) {
+        IMG_Quit();
+        sImage = false;
+    }
+    sVideo = false;
+    SDL_Quit();
+}
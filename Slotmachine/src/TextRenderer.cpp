@@ -0,0 +1,231 @@
+#include "TextRenderer.h"
+#include <stdio.h>
+#include <algorithm>
+
+/**
+ * Constructor for the TextRenderer class.
+ * @param renderer The custom Renderer used to create and draw the glyph atlases.
+ * @param assets The AssetCache that owns the fonts and atlas textures.
+ */
+TextRenderer::TextRenderer(std::shared_ptr<Renderer> renderer, std::shared_ptr<AssetCache> assets)
+    : mRenderer(renderer), mAssets(assets) {}
+
+/**
+ * Destructor for the TextRenderer class.
+ * Releases the handles to all fonts and atlas textures.
+ */
+TextRenderer::~TextRenderer() {
+    clear();
+}
+
+/**
+ * Opens a font and builds its glyph atlas, or returns the existing one.
+ * @param path The file path to the font.
+ * @param size The point size of the font.
+ * @return The font id, or -1 if the font could not be loaded.
+ */
+TextRenderer::FontId TextRenderer::loadFont(const std::string& path, int size) {
+    auto key = std::make_pair(path, size);
+    auto it = mFontIndex.find(key);
+    if (it != mFontIndex.end()) {
+        return it->second;
+    }
+
+    FontAtlas atlas = {};
+    atlas.font = mAssets->getFont(path, size);
+    if (!atlas.font) {
+        return -1;
+    }
+    atlas.height = TTF_FontHeight(atlas.font.get());
+
+    if (!buildAtlas(atlas, "glyphs:" + path + "@" + std::to_string(size))) {
+        return -1;
+    }
+
+    FontId id = static_cast<FontId>(mFonts.size());
+    mFonts.push_back(atlas);
+    mFontIndex[key] = id;
+    return id;
+}
+
+/**
+ * Rasterizes the printable ASCII range into a single texture.
+ * Glyphs are rendered white so the color can be applied with a color mod at draw time.
+ * @param atlas The font atlas to fill in.
+ * @param key The AssetCache key for the atlas texture.
+ * @return True if the atlas texture was created, false otherwise.
+ */
+bool TextRenderer::buildAtlas(FontAtlas& atlas, const std::string& key) {
+    SDL_Color white = { 255, 255, 255, 255 };
+    std::vector<SDL_Surface*> surfaces(GLYPH_COUNT, nullptr);
+
+    // Shelf-pack the glyphs into rows of ATLAS_WIDTH pixels
+    int penX = 0;
+    int penY = 0;
+    int rowHeight = 0;
+    for (int i = 0; i < GLYPH_COUNT; ++i) {
+        Uint16 ch = static_cast<Uint16>(FIRST_GLYPH + i);
+        Glyph& glyph = atlas.glyphs[i];
+        glyph.src = { 0, 0, 0, 0 };
+        glyph.advance = 0;
+
+        int minx, maxx, miny, maxy;
+        if (TTF_GlyphMetrics(atlas.font.get(), ch, &minx, &maxx, &miny, &maxy, &glyph.advance) != 0) {
+            continue;
+        }
+
+        surfaces[i] = TTF_RenderGlyph_Blended(atlas.font.get(), ch, white);
+        if (surfaces[i] == nullptr) {
+            continue; // Whitespace and missing glyphs only advance the pen
+        }
+
+        int w = surfaces[i]->w;
+        int h = surfaces[i]->h;
+        if (penX + w > ATLAS_WIDTH) {
+            penX = 0;
+            penY += rowHeight + 1;
+            rowHeight = 0;
+        }
+        glyph.src = { penX, penY, w, h };
+        penX += w + 1; // 1px gutter to avoid bleeding between glyphs
+        rowHeight = std::max(rowHeight, h);
+    }
+    int atlasHeight = penY + rowHeight;
+
+    bool success = false;
+    SDL_Surface* atlasSurface = SDL_CreateRGBSurfaceWithFormat(0, ATLAS_WIDTH, std::max(atlasHeight, 1), 32, SDL_PIXELFORMAT_ARGB8888);
+    if (atlasSurface == nullptr) {
+        printf("Unable to create glyph atlas surface! SDL Error: %s\n", SDL_GetError());
+    }
+    else {
+        SDL_FillRect(atlasSurface, nullptr, 0);
+        for (int i = 0; i < GLYPH_COUNT; ++i) {
+            if (surfaces[i] != nullptr) {
+                // Copy the glyph coverage as-is instead of blending it onto the empty atlas
+                SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+                SDL_Rect dst = atlas.glyphs[i].src;
+                SDL_BlitSurface(surfaces[i], nullptr, atlasSurface, &dst);
+            }
+        }
+
+        SDL_Texture* texture = mRenderer->createTexture(atlasSurface);
+        if (texture == nullptr) {
+            printf("Unable to create glyph atlas texture!\n");
+        }
+        else {
+            mRenderer->setTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+            atlas.texture = mAssets->adoptTexture(key, texture);
+            success = true;
+        }
+        SDL_FreeSurface(atlasSurface);
+    }
+
+    for (SDL_Surface* surface : surfaces) {
+        if (surface != nullptr) {
+            SDL_FreeSurface(surface);
+        }
+    }
+    return success;
+}
+
+/**
+ * Lays out a string with the given font, or returns the cached layout.
+ * Characters outside the printable ASCII range are skipped.
+ * @param font The font id returned by loadFont.
+ * @param text The string to lay out.
+ * @return The text id, or -1 if the font is invalid.
+ */
+TextRenderer::TextId TextRenderer::prepareText(FontId font, const std::string& text) {
+    if (font < 0 || font >= static_cast<FontId>(mFonts.size())) {
+        return -1;
+    }
+
+    auto key = std::make_pair(font, text);
+    auto it = mLayoutIndex.find(key);
+    if (it != mLayoutIndex.end()) {
+        return it->second;
+    }
+
+    const FontAtlas& atlas = mFonts[font];
+    TextLayout layout;
+    layout.font = font;
+    layout.height = atlas.height;
+
+    int penX = 0;
+    for (char c : text) {
+        int index = static_cast<unsigned char>(c) - FIRST_GLYPH;
+        if (index < 0 || index >= GLYPH_COUNT) {
+            continue;
+        }
+        const Glyph& glyph = atlas.glyphs[index];
+        if (glyph.src.w > 0 && glyph.src.h > 0) {
+            Quad quad;
+            quad.src = glyph.src;
+            quad.dst = { penX, 0, glyph.src.w, glyph.src.h };
+            layout.quads.push_back(quad);
+        }
+        penX += glyph.advance;
+    }
+    layout.width = penX;
+
+    TextId id = static_cast<TextId>(mLayouts.size());
+    mLayouts.push_back(layout);
+    mLayoutIndex[key] = id;
+    return id;
+}
+
+/**
+ * Draws a prepared string from its font atlas.
+ * @param text The text id returned by prepareText.
+ * @param x The x-coordinate of the top-left corner of the text.
+ * @param y The y-coordinate of the top-left corner of the text.
+ * @param color The color of the text.
+ */
+void TextRenderer::drawText(TextId text, int x, int y, SDL_Color color) {
+    if (text < 0 || text >= static_cast<TextId>(mLayouts.size())) {
+        return;
+    }
+
+    const TextLayout& layout = mLayouts[text];
+    SDL_Texture* texture = mFonts[layout.font].texture.get();
+    mRenderer->setTextureColorMod(texture, color);
+
+    for (const Quad& quad : layout.quads) {
+        SDL_Rect dst = { x + quad.dst.x, y + quad.dst.y, quad.dst.w, quad.dst.h };
+        mRenderer->renderTexture(texture, &quad.src, &dst);
+    }
+}
+
+/**
+ * Gets the width of a prepared string.
+ * @param text The text id returned by prepareText.
+ * @return The width in pixels, or 0 if the id is invalid.
+ */
+int TextRenderer::getTextWidth(TextId text) const {
+    if (text < 0 || text >= static_cast<TextId>(mLayouts.size())) {
+        return 0;
+    }
+    return mLayouts[text].width;
+}
+
+/**
+ * Gets the height of a prepared string.
+ * @param text The text id returned by prepareText.
+ * @return The height in pixels, or 0 if the id is invalid.
+ */
+int TextRenderer::getTextHeight(TextId text) const {
+    if (text < 0 || text >= static_cast<TextId>(mLayouts.size())) {
+        return 0;
+    }
+    return mLayouts[text].height;
+}
+
+/**
+ * Releases all fonts, atlas textures and cached layouts.
+ */
+void TextRenderer::clear() {
+    mFonts.clear();
+    mFontIndex.clear();
+    mLayouts.clear();
+    mLayoutIndex.clear();
+}
@@ -1,8 +1,14 @@
 #include "MainGame.h"
+#include "Profiler.h"
+#include <cstring>
+#include <cstdlib>
 
 /**
  * The main entry point of the application.
  * Initializes the game, loads media, and runs the game loop.
+ * Frame pacing can be changed with --fps <rate> (0 for unlimited) and --no-vsync.
+ * --profile records profiler zones from startup (F8 toggles them at runtime).
+ * --seed <n> replays the spins of an earlier run.
  * @param argc The number of command-line arguments.
  * @param args The array of command-line arguments.
  * @return The exit status of the application.
@@ -10,6 +16,28 @@
 int main(int argc, char* args[]) {
     MainGame game;
 
+    // Parse frame pacing options
+    int targetFrameRate = TARGET_FRAME_RATE;
+    bool vsync = USE_VSYNC;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(args[i], "--fps") == 0 && i + 1 < argc) {
+            targetFrameRate = std::atoi(args[++i]);
+        }
+        else if (std::strcmp(args[i], "--vsync") == 0) {
+            vsync = true;
+        }
+        else if (std::strcmp(args[i], "--no-vsync") == 0) {
+            vsync = false;
+        }
+        else if (std::strcmp(args[i], "--profile") == 0) {
+            Profiler::setEnabled(true);
+        }
+        else if (std::strcmp(args[i], "--seed") == 0 && i + 1 < argc) {
+            game.setRandomSeed(std::strtoull(args[++i], nullptr, 10));
+        }
+    }
+    game.setFramePacing(targetFrameRate, vsync);
+
     // Initialize the game
     if (!game.init()) {
         printf("Failed to initialize!\n");